@@ -508,8 +508,31 @@ INT32 HVC_Execute(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *
 /*          :                               other...signal error              */
 /*----------------------------------------------------------------------------*/
 INT32 HVC_ExecuteEx(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus)
+{
+    return HVC_ExecuteExProgress(inTimeOutTime, inExec, inImage, outHVCResult, outStatus, NULL, 0, NULL);
+}
+
+/*----------------------------------------------------------------------------*/
+/* HVC_ExecuteExProgress                                                      */
+/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image info                        */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+/*          : HVC_PROGRESS_FUNC inProgress  progress callback (NULL...none)   */
+/*          : INT32         inRowStep       image rows per progress           */
+/*          :                               (0...whole image at once)         */
+/*          : void          *inUserData     passed to the callback            */
+/* return   : INT32                         execution result error code       */
+/*          :                               0...normal                        */
+/*          :                               -1...parameter error              */
+/*          :                               other...signal error              */
+/*----------------------------------------------------------------------------*/
+INT32 HVC_ExecuteExProgress(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus,
+                            HVC_PROGRESS_FUNC inProgress, INT32 inRowStep, void *inUserData)
 {
     int i, j;
+    INT32 rows, stepRows;
     INT32 ret = 0;
     INT32 size = 0;
     UINT8 sendData[32];
@@ -670,6 +693,11 @@ INT32 HVC_ExecuteEx(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT
         }
     }
 
+    /* Detection results are ready before the image */
+    if ( (NULL != inProgress) && (0 == *outStatus) ) {
+        inProgress(HVC_PROGRESS_RESULT, 0, outHVCResult, inUserData);
+    }
+
     if(HVC_EXECUTE_IMAGE_NONE != inImage){
         /* Image data */
         if ( size >= (INT32)sizeof(UINT8)*4 ) {
@@ -681,8 +709,18 @@ INT32 HVC_ExecuteEx(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT
         }
 
         if ( size >= (INT32)sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height ) {
-            ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height, outHVCResult->image.image);
-            if ( ret != 0 ) return ret;
+            /* Receive rows step by step */
+            stepRows = ((NULL != inProgress) && (inRowStep > 0)) ? inRowStep : outHVCResult->image.height;
+            for(rows = 0; rows < outHVCResult->image.height; rows += stepRows){
+                if ( rows + stepRows > outHVCResult->image.height ) {
+                    stepRows = outHVCResult->image.height - rows;
+                }
+                ret = HVC_ReceiveData(inTimeOutTime, sizeof(UINT8)*outHVCResult->image.width*stepRows, outHVCResult->image.image + outHVCResult->image.width*rows);
+                if ( ret != 0 ) return ret;
+                if ( NULL != inProgress ) {
+                    inProgress(HVC_PROGRESS_IMAGE_ROWS, rows + stepRows, outHVCResult, inUserData);
+                }
+            }
             size -= sizeof(UINT8)*outHVCResult->image.width*outHVCResult->image.height;
         }
     }
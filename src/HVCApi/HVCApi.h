@@ -71,6 +71,28 @@ INT32 HVC_Execute(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *
 /*          : UINT8         *outStatus      response code                     */
 INT32 HVC_ExecuteEx(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus);
 
+/* Progress callback of HVC_ExecuteExProgress                                 */
+/* param    : INT32         inEvent         HVC_PROGRESS_RESULT or            */
+/*          :                               HVC_PROGRESS_IMAGE_ROWS           */
+/*          : INT32         inRows          received image rows               */
+/*          : HVC_RESULT    *inHVCResult    result data (being received)      */
+/*          : void          *inUserData     user data                         */
+#define HVC_PROGRESS_RESULT             0   /* detection results are parsed  */
+#define HVC_PROGRESS_IMAGE_ROWS         1   /* image rows are received       */
+typedef void (*HVC_PROGRESS_FUNC)(INT32 inEvent, INT32 inRows, const HVC_RESULT *inHVCResult, void *inUserData);
+
+/* HVC_ExecuteExProgress                                                      */
+/* param    : INT32         inTimeOutTime   timeout time (ms)                 */
+/*          : INT32         inExec          executable function               */
+/*          : INT32         inImage         image output number               */
+/*          : HVC_RESULT    *outHVCResult   result data                       */
+/*          : UINT8         *outStatus      response code                     */
+/*          : HVC_PROGRESS_FUNC inProgress  progress callback                 */
+/*          : INT32         inRowStep       image rows per progress           */
+/*          : void          *inUserData     passed to the callback            */
+INT32 HVC_ExecuteExProgress(INT32 inTimeOutTime, INT32 inExec, INT32 inImage, HVC_RESULT *outHVCResult, UINT8 *outStatus,
+                            HVC_PROGRESS_FUNC inProgress, INT32 inRowStep, void *inUserData);
+
 /* HVC_SetThreshold                                                           */
 /* param    : INT32         inTimeOutTime   timeout time (ms)                 */
 /*          : HVC_THRESHOLD *inThreshold    threshold values                  */
@@ -0,0 +1,781 @@
+/*
+    Native implementation of STBAPI.h
+
+    Used instead of the prebuilt STB library with compilers other than MSVC
+    (the library is linked by STBWrap.c only with MSVC), or when OFXHVCP2_NATIVE_STB is defined.
+    Every handle owns its state, so several handles can run on different threads.
+
+    Tracking   : detections are associated with tracks by IoU and center distance.
+                 Greedy matching when there is no conflict, Hungarian method otherwise.
+                 A lost track is kept for RetryCount frames.
+                 Position / size is updated only if the change is larger than
+                 steadiness (% of size).
+    Property   : age and gender are confidence-weighted votes of the frames that
+                 pass the detection threshold and face angle range.
+                 Status is COMPLETE when the frame count is reached, then FIXED.
+    Recognition: majority vote of user IDs with the same conditions and min ratio.
+
+    Output of STB_GetFaces / STB_GetBodies is one entry per detection of the
+    current frame, in detection order (nDetectID == index).
+*/
+
+#if !defined(_MSC_VER) || defined(OFXHVCP2_NATIVE_STB)
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "STBAPI.h"
+#include "STBCommonDef.h"
+
+namespace {
+
+const int STB_NATIVE_MAX_DETECT = 35;
+const int STB_NATIVE_MAX_TRACK = STB_NATIVE_MAX_DETECT * 2;
+const int STB_NATIVE_MAX_UID = 8;
+const float STB_NATIVE_NO_MATCH = 1e9f;
+
+/* Parameter ranges */
+const int STB_NATIVE_RETRY_MAX = 300;
+const int STB_NATIVE_STEADINESS_MAX = 100;
+const int STB_NATIVE_THRESHOLD_MAX = 1000;
+const int STB_NATIVE_ANGLE_MAX = 90;
+const int STB_NATIVE_FRAME_COUNT_MAX = 20;
+
+struct PropertyParam {
+    int threshold;
+    int minUD, maxUD;
+    int minLR, maxLR;
+    int frameCount;
+    int minRatio;   /* recognition only */
+};
+
+struct Vote {
+    int count;
+    int fixed;      /* 0: calculating, 1: complete (this frame), 2: fixed */
+    double weightSum;
+    double valueSum;
+    double confSum;
+    int value;
+    int conf;
+    int uid[STB_NATIVE_MAX_UID];
+    int uidCount[STB_NATIVE_MAX_UID];
+};
+
+struct Track {
+    int id;
+    int detectId;
+    int missed;
+    float x, y, size;
+    Vote age, gender, recognition;
+};
+
+struct TrackList {
+    std::vector<Track> tracks;
+    int matchOfDetect[STB_NATIVE_MAX_DETECT];
+};
+
+struct Handle {
+    STB_UINT32 funcFlag;
+    int retryCount;
+    int posSteadiness;
+    int sizeSteadiness;
+    PropertyParam pe;
+    PropertyParam fr;
+
+    int hasFrame;
+    STB_FRAME_RESULT frame;
+    int nextId;
+    TrackList faces;
+    TrackList bodies;
+
+    /* work area of association */
+    float cost[STB_NATIVE_MAX_TRACK * STB_NATIVE_MAX_TRACK];
+    int candidates[STB_NATIVE_MAX_TRACK];
+};
+
+/*------------------------------------------------------------------------------------------------*/
+/* Association                                                                                    */
+/*------------------------------------------------------------------------------------------------*/
+
+/* 0 for same box, 1 for no overlap, larger for farther. STB_NATIVE_NO_MATCH outside of gate. */
+float MatchCost(const STB_POINT &center, int size, const Track &track)
+{
+    float dx = center.nX - track.x;
+    float dy = center.nY - track.y;
+    float meanSize = (size + track.size) / 2;
+    float distance = sqrtf(dx * dx + dy * dy);
+    if (meanSize <= 0 || distance > meanSize) return STB_NATIVE_NO_MATCH;
+    if (size > track.size * 2 || track.size > size * 2) return STB_NATIVE_NO_MATCH;
+
+    /* IoU of square boxes */
+    float ax0 = center.nX - size / 2.0f, ax1 = ax0 + size;
+    float ay0 = center.nY - size / 2.0f, ay1 = ay0 + size;
+    float bx0 = track.x - track.size / 2, bx1 = bx0 + track.size;
+    float by0 = track.y - track.size / 2, by1 = by0 + track.size;
+    float w = fminf(ax1, bx1) - fmaxf(ax0, bx0);
+    float h = fminf(ay1, by1) - fmaxf(ay0, by0);
+    float inter = (w > 0 && h > 0) ? w * h : 0;
+    float iou = inter / ((float)size * size + track.size * track.size - inter);
+    if (iou > 0) return 1 - iou;
+    return 1 + distance / meanSize;
+}
+
+/* Hungarian method for rows <= cols (potential form, O(n^2 m)). outRowMatch[r] = col or -1 */
+void SolveAssignment(const float *cost, int rows, int cols, int *outRowMatch)
+{
+    const double inf = 1e18;
+    std::vector<double> u(rows + 1, 0), v(cols + 1, 0), minv(cols + 1);
+    std::vector<int> p(cols + 1, 0), way(cols + 1, 0);
+    std::vector<char> used(cols + 1);
+
+    for (int i = 1; i <= rows; i++) {
+        p[0] = i;
+        int j0 = 0;
+        std::fill(minv.begin(), minv.end(), inf);
+        std::fill(used.begin(), used.end(), 0);
+        do {
+            used[j0] = 1;
+            int i0 = p[j0], j1 = 0;
+            double delta = inf;
+            for (int j = 1; j <= cols; j++) {
+                if (used[j]) continue;
+                double cur = cost[(i0 - 1) * cols + (j - 1)] - u[i0] - v[j];
+                if (cur < minv[j]) { minv[j] = cur; way[j] = j0; }
+                if (minv[j] < delta) { delta = minv[j]; j1 = j; }
+            }
+            for (int j = 0; j <= cols; j++) {
+                if (used[j]) { u[p[j]] += delta; v[j] -= delta; }
+                else { minv[j] -= delta; }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        do {
+            int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0);
+    }
+
+    for (int i = 0; i < rows; i++) outRowMatch[i] = -1;
+    for (int j = 1; j <= cols; j++) {
+        if (p[j] != 0 && cost[(p[j] - 1) * cols + (j - 1)] < STB_NATIVE_NO_MATCH) {
+            outRowMatch[p[j] - 1] = j - 1;
+        }
+    }
+}
+
+/* centers / sizes are taken with stride, so faces and bodies share this */
+void Associate(Handle *h, TrackList &list, int count, const STB_POINT *centers, const STB_INT32 *sizes, int stride)
+{
+    int numTracks = (int)list.tracks.size();
+    int conflict = 0;
+
+    /* cost matrix detections x tracks, and check if greedy is enough */
+    for (int j = 0; j < numTracks; j++) h->candidates[j] = 0;
+    for (int i = 0; i < count; i++) {
+        const STB_POINT &c = *(const STB_POINT *)((const char *)centers + i * stride);
+        int size = *(const STB_INT32 *)((const char *)sizes + i * stride);
+        int numCandidates = 0;
+        for (int j = 0; j < numTracks; j++) {
+            float cost = MatchCost(c, size, list.tracks[j]);
+            h->cost[i * numTracks + j] = cost;
+            if (cost < STB_NATIVE_NO_MATCH) {
+                numCandidates++;
+                if (++h->candidates[j] > 1) conflict = 1;
+            }
+        }
+        if (numCandidates > 1) conflict = 1;
+    }
+
+    /* sparse scene: every candidate is the only one */
+    if (!conflict) {
+        for (int i = 0; i < count; i++) {
+            list.matchOfDetect[i] = -1;
+            for (int j = 0; j < numTracks; j++) {
+                if (h->cost[i * numTracks + j] < STB_NATIVE_NO_MATCH) list.matchOfDetect[i] = j;
+            }
+        }
+        return;
+    }
+
+    if (count <= numTracks) {
+        SolveAssignment(h->cost, count, numTracks, list.matchOfDetect);
+        return;
+    }
+
+    /* more detections than tracks: solve transposed problem */
+    static_assert(STB_NATIVE_MAX_TRACK * STB_NATIVE_MAX_TRACK >= 2 * STB_NATIVE_MAX_DETECT * STB_NATIVE_MAX_TRACK, "work area");
+    float *transposed = h->cost + count * numTracks;
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < numTracks; j++) transposed[j * count + i] = h->cost[i * numTracks + j];
+    }
+    int trackMatch[STB_NATIVE_MAX_TRACK];
+    SolveAssignment(transposed, numTracks, count, trackMatch);
+    for (int i = 0; i < count; i++) list.matchOfDetect[i] = -1;
+    for (int j = 0; j < numTracks; j++) {
+        if (trackMatch[j] >= 0) list.matchOfDetect[trackMatch[j]] = j;
+    }
+}
+
+void Steady(const Handle *h, Track &track, const STB_POINT &center, int size)
+{
+    float dx = center.nX - track.x;
+    float dy = center.nY - track.y;
+    float posLimit = track.size * h->posSteadiness / 100.0f;
+    if (fabsf(dx) > posLimit || fabsf(dy) > posLimit) {
+        track.x = (float)center.nX;
+        track.y = (float)center.nY;
+    }
+    float sizeLimit = track.size * h->sizeSteadiness / 100.0f;
+    if (fabsf(size - track.size) > sizeLimit) {
+        track.size = (float)size;
+    }
+}
+
+/* update tracks with associated detections, drop lost tracks and add new tracks */
+void UpdateTracks(Handle *h, TrackList &list, int count, const STB_POINT *centers, const STB_INT32 *sizes, int stride)
+{
+    int numTracks = (int)list.tracks.size();
+    int matched[STB_NATIVE_MAX_TRACK] = { 0 };
+
+    for (int i = 0; i < count; i++) {
+        const STB_POINT &c = *(const STB_POINT *)((const char *)centers + i * stride);
+        int size = *(const STB_INT32 *)((const char *)sizes + i * stride);
+        int j = list.matchOfDetect[i];
+        if (j >= 0) {
+            matched[j] = 1;
+            Steady(h, list.tracks[j], c, size);
+            list.tracks[j].detectId = i;
+            list.tracks[j].missed = 0;
+        }
+    }
+
+    /* lost tracks */
+    for (int j = numTracks - 1; j >= 0; j--) {
+        if (matched[j]) continue;
+        list.tracks[j].detectId = -1;
+        if (++list.tracks[j].missed > h->retryCount) {
+            list.tracks.erase(list.tracks.begin() + j);
+        }
+    }
+
+    /* new tracks */
+    for (int i = 0; i < count; i++) {
+        if (list.matchOfDetect[i] >= 0) continue;
+        if ((int)list.tracks.size() >= STB_NATIVE_MAX_TRACK) {
+            /* no space, give up the longest retrying track */
+            int oldest = -1;
+            for (int j = 0; j < (int)list.tracks.size(); j++) {
+                if (list.tracks[j].detectId < 0 && (oldest < 0 || list.tracks[j].missed > list.tracks[oldest].missed)) oldest = j;
+            }
+            if (oldest < 0) break;
+            list.tracks.erase(list.tracks.begin() + oldest);
+        }
+        const STB_POINT &c = *(const STB_POINT *)((const char *)centers + i * stride);
+        int size = *(const STB_INT32 *)((const char *)sizes + i * stride);
+
+        Track track;
+        memset(&track, 0, sizeof(track));
+        track.id = h->nextId++;
+        track.detectId = i;
+        track.x = (float)c.nX;
+        track.y = (float)c.nY;
+        track.size = (float)size;
+        list.tracks.push_back(track);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/* Property estimation                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+int IsUsable(const PropertyParam &param, const STB_FRAME_RESULT_FACE &face)
+{
+    return face.nConfidence >= param.threshold
+        && face.direction.nUD >= param.minUD && face.direction.nUD <= param.maxUD
+        && face.direction.nLR >= param.minLR && face.direction.nLR <= param.maxLR;
+}
+
+void VoteAge(const PropertyParam &param, Vote &vote, const STB_FRAME_RESULT_FACE &face)
+{
+    if (vote.fixed) return;
+    if (face.age.nAge < 0 || face.age.nConfidence <= 0 || !IsUsable(param, face)) return;
+
+    vote.count++;
+    vote.weightSum += face.age.nConfidence;
+    vote.valueSum += (double)face.age.nAge * face.age.nConfidence;
+    vote.confSum += face.age.nConfidence;
+    vote.value = (int)(vote.valueSum / vote.weightSum + 0.5);
+    vote.conf = (int)(vote.confSum / vote.count);
+}
+
+void VoteGender(const PropertyParam &param, Vote &vote, const STB_FRAME_RESULT_FACE &face)
+{
+    if (vote.fixed) return;
+    if (face.gender.nGender < 0 || face.gender.nConfidence <= 0 || !IsUsable(param, face)) return;
+
+    /* male(1) is plus, female(0) is minus */
+    vote.count++;
+    vote.valueSum += face.gender.nGender == 1 ? face.gender.nConfidence : -face.gender.nConfidence;
+    vote.confSum += face.gender.nConfidence;
+    vote.value = vote.valueSum >= 0 ? 1 : 0;
+    vote.conf = (int)(vote.confSum / vote.count);
+}
+
+void VoteRecognition(const PropertyParam &param, Vote &vote, const STB_FRAME_RESULT_FACE &face)
+{
+    int i;
+    if (vote.fixed) return;
+    if (face.recognition.nScore < 0 || !IsUsable(param, face)) return;
+
+    /* negative UID (not registered) is also voted */
+    int uid = face.recognition.nScore >= param.threshold ? face.recognition.nUID : -1;
+    vote.count++;
+    vote.confSum += face.recognition.nScore;
+    for (i = 0; i < STB_NATIVE_MAX_UID; i++) {
+        if (vote.uidCount[i] > 0 && vote.uid[i] == uid) break;
+    }
+    if (i == STB_NATIVE_MAX_UID) {
+        /* replace the weakest candidate */
+        int weakest = 0;
+        for (i = 1; i < STB_NATIVE_MAX_UID; i++) {
+            if (vote.uidCount[i] < vote.uidCount[weakest]) weakest = i;
+        }
+        i = weakest;
+        vote.uid[i] = uid;
+        vote.uidCount[i] = 0;
+    }
+    vote.uidCount[i]++;
+
+    int best = 0;
+    for (i = 1; i < STB_NATIVE_MAX_UID; i++) {
+        if (vote.uidCount[i] > vote.uidCount[best]) best = i;
+    }
+    vote.value = vote.uid[best];
+    vote.conf = (int)(vote.confSum / vote.count);
+}
+
+/* status and fixing after vote */
+void Complete(const PropertyParam &param, Vote &vote, int ratioCheck, STB_RES &out)
+{
+    if (vote.fixed == 1) {
+        vote.fixed = 2;
+    }
+    else if (vote.fixed == 0 && vote.count >= param.frameCount) {
+        int ok = 1;
+        if (ratioCheck) {
+            int best = 0;
+            for (int i = 0; i < STB_NATIVE_MAX_UID; i++) {
+                if (vote.uidCount[i] > best) best = vote.uidCount[i];
+            }
+            ok = best * 100 >= param.minRatio * vote.count;
+        }
+        if (ok) vote.fixed = 1;
+    }
+
+    if (vote.count == 0) {
+        out.status = STB_STATUS_NO_DATA;
+        out.conf = STB_CONF_NO_DATA;
+        out.value = -1;
+        return;
+    }
+    out.status = vote.fixed == 2 ? STB_STATUS_FIXED : vote.fixed == 1 ? STB_STATUS_COMPLETE : STB_STATUS_CALCULATING;
+    out.conf = vote.conf;
+    out.value = vote.value;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/* Output                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+void MakeFace(const Handle *h, Track &track, const STB_FRAME_RESULT_FACE &in, STB_FACE &out)
+{
+    int i, top;
+    memset(&out, 0, sizeof(out));
+    out.nDetectID = track.detectId;
+    out.nTrackingID = track.id;
+    out.center.x = (STB_UINT32)(track.x + 0.5f);
+    out.center.y = (STB_UINT32)(track.y + 0.5f);
+    out.nSize = (STB_UINT32)(track.size + 0.5f);
+    out.conf = in.nConfidence;
+
+    if (h->funcFlag & STB_FUNC_PT) {
+        out.direction.status = STB_STATUS_COMPLETE;
+        out.direction.conf = in.direction.nConfidence;
+        out.direction.yaw = in.direction.nLR;
+        out.direction.pitch = in.direction.nUD;
+        out.direction.roll = in.direction.nRoll;
+    }
+    else {
+        out.direction.status = STB_STATUS_NO_DATA;
+        out.direction.conf = STB_CONF_NO_DATA;
+    }
+
+    if (h->funcFlag & STB_FUNC_AG) Complete(h->pe, track.age, 0, out.age);
+    else { out.age.status = STB_STATUS_NO_DATA; out.age.conf = STB_CONF_NO_DATA; out.age.value = -1; }
+    if (h->funcFlag & STB_FUNC_GN) Complete(h->pe, track.gender, 0, out.gender);
+    else { out.gender.status = STB_STATUS_NO_DATA; out.gender.conf = STB_CONF_NO_DATA; out.gender.value = -1; }
+    if (h->funcFlag & STB_FUNC_FR) Complete(h->fr, track.recognition, 1, out.recognition);
+    else { out.recognition.status = STB_STATUS_NO_DATA; out.recognition.conf = STB_CONF_NO_DATA; out.recognition.value = -1; }
+
+    /* not stabilized, pass through */
+    if (h->funcFlag & STB_FUNC_GZ) {
+        out.gaze.status = STB_STATUS_COMPLETE;
+        out.gaze.conf = STB_CONF_NO_DATA;
+        out.gaze.UD = in.gaze.nUD;
+        out.gaze.LR = in.gaze.nLR;
+    }
+    else {
+        out.gaze.status = STB_STATUS_NO_DATA;
+        out.gaze.conf = STB_CONF_NO_DATA;
+    }
+    if (h->funcFlag & STB_FUNC_BL) {
+        out.blink.status = STB_STATUS_COMPLETE;
+        out.blink.ratioL = in.blink.nLeftEye;
+        out.blink.ratioR = in.blink.nRightEye;
+    }
+    else {
+        out.blink.status = STB_STATUS_NO_DATA;
+    }
+    if (h->funcFlag & STB_FUNC_EX) {
+        top = 0;
+        for (i = 1; i < STB_Expression_Max; i++) {
+            if (in.expression.anScore[i] > in.expression.anScore[top]) top = i;
+        }
+        out.expression.status = STB_STATUS_COMPLETE;
+        out.expression.conf = in.expression.anScore[top];
+        out.expression.value = top;
+    }
+    else {
+        out.expression.status = STB_STATUS_NO_DATA;
+        out.expression.conf = STB_CONF_NO_DATA;
+        out.expression.value = STB_EX_UNKNOWN;
+    }
+}
+
+int CheckRange(int value, int min, int max)
+{
+    return value >= min && value <= max;
+}
+
+int CheckPropertyParam(int threshold, int minUD, int maxUD, int minLR, int maxLR)
+{
+    return CheckRange(threshold, 0, STB_NATIVE_THRESHOLD_MAX)
+        && CheckRange(minUD, -STB_NATIVE_ANGLE_MAX, STB_NATIVE_ANGLE_MAX) && CheckRange(maxUD, minUD, STB_NATIVE_ANGLE_MAX)
+        && CheckRange(minLR, -STB_NATIVE_ANGLE_MAX, STB_NATIVE_ANGLE_MAX) && CheckRange(maxLR, minLR, STB_NATIVE_ANGLE_MAX);
+}
+
+} // namespace
+
+extern "C" {
+
+STB_INT32 STB_GetVersion(STB_INT8* pnMajorVersion, STB_INT8* pnMinorVersion)
+{
+    if (NULL == pnMajorVersion || NULL == pnMinorVersion) return STB_ERR_INVALIDPARAM;
+    *pnMajorVersion = 1;
+    *pnMinorVersion = 0;
+    return STB_NORMAL;
+}
+
+HSTB STB_CreateHandle(STB_UINT32 unUseFuncFlag)
+{
+    Handle *h = new Handle();
+    h->funcFlag = unUseFuncFlag;
+    h->retryCount = 2;
+    h->posSteadiness = 30;
+    h->sizeSteadiness = 30;
+    h->pe.threshold = 300;
+    h->pe.minUD = -15; h->pe.maxUD = 20;
+    h->pe.minLR = -20; h->pe.maxLR = 20;
+    h->pe.frameCount = 5;
+    h->pe.minRatio = 0;
+    h->fr = h->pe;
+    h->fr.minRatio = 60;
+    h->hasFrame = 0;
+    h->nextId = 1;
+    h->faces.tracks.reserve(STB_NATIVE_MAX_TRACK);
+    h->bodies.tracks.reserve(STB_NATIVE_MAX_TRACK);
+    return h;
+}
+
+VOID STB_DeleteHandle(HSTB hSTB)
+{
+    delete (Handle *)hSTB;
+}
+
+STB_INT32 STB_SetFrameResult(HSTB hSTB, const STB_FRAME_RESULT *stFrameResult)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == stFrameResult
+        || !CheckRange(stFrameResult->faces.nCount, 0, STB_NATIVE_MAX_DETECT)
+        || !CheckRange(stFrameResult->bodys.nCount, 0, STB_NATIVE_MAX_DETECT)) {
+        return STB_ERR_INVALIDPARAM;
+    }
+    h->frame = *stFrameResult;
+    h->hasFrame = 1;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_ClearFrameResults(HSTB hSTB)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    h->hasFrame = 0;
+    h->faces.tracks.clear();
+    h->bodies.tracks.clear();
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_Execute(HSTB hSTB)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!h->hasFrame) return STB_ERR_PROCESSCONDITION;
+
+    const STB_FRAME_RESULT_FACES &faces = h->frame.faces;
+    const STB_FRAME_RESULT_BODYS &bodies = h->frame.bodys;
+
+    if (h->funcFlag & STB_FUNC_DT) {
+        Associate(h, h->faces, faces.nCount, &faces.face[0].center, &faces.face[0].nSize, sizeof(STB_FRAME_RESULT_FACE));
+        UpdateTracks(h, h->faces, faces.nCount, &faces.face[0].center, &faces.face[0].nSize, sizeof(STB_FRAME_RESULT_FACE));
+        for (size_t j = 0; j < h->faces.tracks.size(); j++) {
+            Track &track = h->faces.tracks[j];
+            if (track.detectId < 0) continue;
+            const STB_FRAME_RESULT_FACE &face = faces.face[track.detectId];
+            if (h->funcFlag & STB_FUNC_AG) VoteAge(h->pe, track.age, face);
+            if (h->funcFlag & STB_FUNC_GN) VoteGender(h->pe, track.gender, face);
+            if (h->funcFlag & STB_FUNC_FR) VoteRecognition(h->fr, track.recognition, face);
+        }
+    }
+    if (h->funcFlag & STB_FUNC_BD) {
+        Associate(h, h->bodies, bodies.nCount, &bodies.body[0].center, &bodies.body[0].nSize, sizeof(STB_FRAME_RESULT_DETECTION));
+        UpdateTracks(h, h->bodies, bodies.nCount, &bodies.body[0].center, &bodies.body[0].nSize, sizeof(STB_FRAME_RESULT_DETECTION));
+    }
+
+    h->hasFrame = 0;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetFaces(HSTB hSTB, STB_UINT32 *punFaceCount, STB_FACE stFace[])
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == punFaceCount || NULL == stFace) return STB_ERR_INVALIDPARAM;
+
+    int count = 0;
+    for (size_t j = 0; j < h->faces.tracks.size(); j++) {
+        Track &track = h->faces.tracks[j];
+        if (track.detectId < 0) continue;
+        MakeFace(h, track, h->frame.faces.face[track.detectId], stFace[track.detectId]);
+        count++;
+    }
+    *punFaceCount = count;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetBodies(HSTB hSTB, STB_UINT32 *punBodyCount, STB_BODY stBody[])
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == punBodyCount || NULL == stBody) return STB_ERR_INVALIDPARAM;
+
+    int count = 0;
+    for (size_t j = 0; j < h->bodies.tracks.size(); j++) {
+        const Track &track = h->bodies.tracks[j];
+        if (track.detectId < 0) continue;
+        STB_BODY &out = stBody[track.detectId];
+        out.nDetectID = track.detectId;
+        out.nTrackingID = track.id;
+        out.center.x = (STB_UINT32)(track.x + 0.5f);
+        out.center.y = (STB_UINT32)(track.y + 0.5f);
+        out.nSize = (STB_UINT32)(track.size + 0.5f);
+        out.conf = h->frame.bodys.body[track.detectId].nConfidence;
+        count++;
+    }
+    *punBodyCount = count;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetTrRetryCount(HSTB hSTB, STB_INT32 nMaxRetryCount)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckRange(nMaxRetryCount, 0, STB_NATIVE_RETRY_MAX)) return STB_ERR_INVALIDPARAM;
+    h->retryCount = nMaxRetryCount;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetTrRetryCount(HSTB hSTB, STB_INT32 *pnMaxRetryCount)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnMaxRetryCount) return STB_ERR_INVALIDPARAM;
+    *pnMaxRetryCount = h->retryCount;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetTrSteadinessParam(HSTB hSTB, STB_INT32 nPosSteadinessParam, STB_INT32 nSizeSteadinessParam)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckRange(nPosSteadinessParam, 0, STB_NATIVE_STEADINESS_MAX) || !CheckRange(nSizeSteadinessParam, 0, STB_NATIVE_STEADINESS_MAX)) {
+        return STB_ERR_INVALIDPARAM;
+    }
+    h->posSteadiness = nPosSteadinessParam;
+    h->sizeSteadiness = nSizeSteadinessParam;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetTrSteadinessParam(HSTB hSTB, STB_INT32 *pnPosSteadinessParam, STB_INT32 *pnSizeSteadinessParam)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnPosSteadinessParam || NULL == pnSizeSteadinessParam) return STB_ERR_INVALIDPARAM;
+    *pnPosSteadinessParam = h->posSteadiness;
+    *pnSizeSteadinessParam = h->sizeSteadiness;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetPeThresholdUse(HSTB hSTB, STB_INT32 nThreshold)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckRange(nThreshold, 0, STB_NATIVE_THRESHOLD_MAX)) return STB_ERR_INVALIDPARAM;
+    h->pe.threshold = nThreshold;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetPeThresholdUse(HSTB hSTB, STB_INT32 *pnThreshold)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnThreshold) return STB_ERR_INVALIDPARAM;
+    *pnThreshold = h->pe.threshold;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetPeAngleUse(HSTB hSTB, STB_INT32 nMinUDAngle, STB_INT32 nMaxUDAngle, STB_INT32 nMinLRAngle, STB_INT32 nMaxLRAngle)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckPropertyParam(0, nMinUDAngle, nMaxUDAngle, nMinLRAngle, nMaxLRAngle)) return STB_ERR_INVALIDPARAM;
+    h->pe.minUD = nMinUDAngle;
+    h->pe.maxUD = nMaxUDAngle;
+    h->pe.minLR = nMinLRAngle;
+    h->pe.maxLR = nMaxLRAngle;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetPeAngleUse(HSTB hSTB, STB_INT32 *pnMinUDAngle, STB_INT32 *pnMaxUDAngle, STB_INT32 *pnMinLRAngle, STB_INT32 *pnMaxLRAngle)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnMinUDAngle || NULL == pnMaxUDAngle || NULL == pnMinLRAngle || NULL == pnMaxLRAngle) return STB_ERR_INVALIDPARAM;
+    *pnMinUDAngle = h->pe.minUD;
+    *pnMaxUDAngle = h->pe.maxUD;
+    *pnMinLRAngle = h->pe.minLR;
+    *pnMaxLRAngle = h->pe.maxLR;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetPeCompleteFrameCount(HSTB hSTB, STB_INT32 nFrameCount)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckRange(nFrameCount, 1, STB_NATIVE_FRAME_COUNT_MAX)) return STB_ERR_INVALIDPARAM;
+    h->pe.frameCount = nFrameCount;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetPeCompleteFrameCount(HSTB hSTB, STB_INT32 *pnFrameCount)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnFrameCount) return STB_ERR_INVALIDPARAM;
+    *pnFrameCount = h->pe.frameCount;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetFrThresholdUse(HSTB hSTB, STB_INT32 nThreshold)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckRange(nThreshold, 0, STB_NATIVE_THRESHOLD_MAX)) return STB_ERR_INVALIDPARAM;
+    h->fr.threshold = nThreshold;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetFrThresholdUse(HSTB hSTB, STB_INT32 *pnThreshold)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnThreshold) return STB_ERR_INVALIDPARAM;
+    *pnThreshold = h->fr.threshold;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetFrAngleUse(HSTB hSTB, STB_INT32 nMinUDAngle, STB_INT32 nMaxUDAngle, STB_INT32 nMinLRAngle, STB_INT32 nMaxLRAngle)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckPropertyParam(0, nMinUDAngle, nMaxUDAngle, nMinLRAngle, nMaxLRAngle)) return STB_ERR_INVALIDPARAM;
+    h->fr.minUD = nMinUDAngle;
+    h->fr.maxUD = nMaxUDAngle;
+    h->fr.minLR = nMinLRAngle;
+    h->fr.maxLR = nMaxLRAngle;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetFrAngleUse(HSTB hSTB, STB_INT32 *pnMinUDAngle, STB_INT32 *pnMaxUDAngle, STB_INT32 *pnMinLRAngle, STB_INT32 *pnMaxLRAngle)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnMinUDAngle || NULL == pnMaxUDAngle || NULL == pnMinLRAngle || NULL == pnMaxLRAngle) return STB_ERR_INVALIDPARAM;
+    *pnMinUDAngle = h->fr.minUD;
+    *pnMaxUDAngle = h->fr.maxUD;
+    *pnMinLRAngle = h->fr.minLR;
+    *pnMaxLRAngle = h->fr.maxLR;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetFrCompleteFrameCount(HSTB hSTB, STB_INT32 nFrameCount)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckRange(nFrameCount, 1, STB_NATIVE_FRAME_COUNT_MAX)) return STB_ERR_INVALIDPARAM;
+    h->fr.frameCount = nFrameCount;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetFrCompleteFrameCount(HSTB hSTB, STB_INT32 *pnFrameCount)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnFrameCount) return STB_ERR_INVALIDPARAM;
+    *pnFrameCount = h->fr.frameCount;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_SetFrMinRatio(HSTB hSTB, STB_INT32 nMinRatio)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (!CheckRange(nMinRatio, 0, 100)) return STB_ERR_INVALIDPARAM;
+    h->fr.minRatio = nMinRatio;
+    return STB_NORMAL;
+}
+
+STB_INT32 STB_GetFrMinRatio(HSTB hSTB, STB_INT32 *pnMinRatio)
+{
+    Handle *h = (Handle *)hSTB;
+    if (NULL == h) return STB_ERR_NOHANDLE;
+    if (NULL == pnMinRatio) return STB_ERR_INVALIDPARAM;
+    *pnMinRatio = h->fr.minRatio;
+    return STB_NORMAL;
+}
+
+} // extern "C"
+
+#endif /* !_MSC_VER || OFXHVCP2_NATIVE_STB */
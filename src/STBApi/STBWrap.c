@@ -21,139 +21,156 @@
 #include <stdlib.h>
 #include "STBWrap.h"
 
+#if defined(_MSC_VER) && !defined(OFXHVCP2_NATIVE_STB)
 #pragma comment(lib, "STB.lib")
+#endif
 
-#define STB_MAX_NUM 35
+static void GetFrameResult(int inActiveFunc, const HVC_RESULT *inResult, STB_FRAME_RESULT *outFrameResult);
 
-static HSTB m_Handle;
-static int m_nFaceCount;
-static STB_FACE m_Face[STB_MAX_NUM];
-static int m_nBodyCount;
-static STB_BODY m_Body[STB_MAX_NUM];
 
-
-int STB_Init(int inFuncFlag)
+int STB_Init(STB_CONTEXT *inContext, int inFuncFlag)
 {
-    if(NULL != m_Handle){
-        STB_DeleteHandle(m_Handle);
-        m_Handle = NULL;
+    if(NULL == inContext){
+        return STB_ERR_INVALIDPARAM;
+    }
+    if(NULL != inContext->handle){
+        STB_DeleteHandle(inContext->handle);
+        inContext->handle = NULL;
     }
+    inContext->nFaceCount = 0;
+    inContext->nBodyCount = 0;
 
-    m_Handle = STB_CreateHandle(inFuncFlag);
-    if(NULL == m_Handle){
+    inContext->handle = STB_CreateHandle(inFuncFlag);
+    if(NULL == inContext->handle){
         return STB_ERR_INITIALIZE;
     }
     return STB_NORMAL;
 }
 
-void STB_Final(void)
+void STB_Final(STB_CONTEXT *inContext)
 {
-    if(NULL != m_Handle){
-        STB_DeleteHandle(m_Handle);
-        m_Handle = NULL;
+    if(NULL != inContext && NULL != inContext->handle){
+        STB_DeleteHandle(inContext->handle);
+        inContext->handle = NULL;
     }
 }
 
-int STB_Exec(int inActiveFunc, const HVC_RESULT *inResult, int *pnSTBFaceCount, STB_FACE **pSTBFaceResult, int *pnSTBBodyCount, STB_BODY **pSTBBodyResult)
+int STB_Exec(STB_CONTEXT *inContext, int inActiveFunc, const HVC_RESULT *inResult, int *pnSTBFaceCount, STB_FACE **pSTBFaceResult, int *pnSTBBodyCount, STB_BODY **pSTBBodyResult)
 {
     int ret;
     STB_FRAME_RESULT frameRes;
 
-    m_nFaceCount = 0;
-    m_nBodyCount = 0;
+    if(NULL == inContext){
+        return STB_ERR_INVALIDPARAM;
+    }
+
+    inContext->nFaceCount = 0;
+    inContext->nBodyCount = 0;
     GetFrameResult(inActiveFunc, inResult, &frameRes);
     do{
         // Set frame information (Detection Result)
-        ret = STB_SetFrameResult(m_Handle, &frameRes);
+        ret = STB_SetFrameResult(inContext->handle, &frameRes);
         if(STB_NORMAL != ret){
             break;
         }
 
         // STB Execution
-        ret = STB_Execute(m_Handle);
+        ret = STB_Execute(inContext->handle);
         if(STB_NORMAL != ret){
             break;
         }
 
         // Get STB Result
-        ret = STB_GetFaces(m_Handle, (STB_UINT32 *)&m_nFaceCount, m_Face);
+        ret = STB_GetFaces(inContext->handle, (STB_UINT32 *)&inContext->nFaceCount, inContext->face);
         if(STB_NORMAL != ret){
             break;
         }
 
-        ret = STB_GetBodies(m_Handle, (STB_UINT32 *)&m_nBodyCount, m_Body);
+        ret = STB_GetBodies(inContext->handle, (STB_UINT32 *)&inContext->nBodyCount, inContext->body);
         if(STB_NORMAL != ret){
             break;
         }
     }while(0);
 
-    *pnSTBFaceCount = m_nFaceCount;
-    *pSTBFaceResult = m_Face;
-    *pnSTBBodyCount = m_nBodyCount;
-    *pSTBBodyResult = m_Body;
+    *pnSTBFaceCount = inContext->nFaceCount;
+    *pSTBFaceResult = inContext->face;
+    *pnSTBBodyCount = inContext->nBodyCount;
+    *pSTBBodyResult = inContext->body;
     return ret;
 }
 
-int STB_Clear(void)
+int STB_Clear(STB_CONTEXT *inContext)
 {
-    return STB_ClearFrameResults(m_Handle);
+    if(NULL == inContext){
+        return STB_ERR_INVALIDPARAM;
+    }
+    return STB_ClearFrameResults(inContext->handle);
 }
 
-int STB_SetTrParam(int inRetryCount, int inStbPosParam, int inStbSizeParam)
+int STB_SetTrParam(STB_CONTEXT *inContext, int inRetryCount, int inStbPosParam, int inStbSizeParam)
 {
     int ret;
+    if(NULL == inContext){
+        return STB_ERR_INVALIDPARAM;
+    }
     do{
-        ret = STB_SetTrRetryCount(m_Handle, inRetryCount);
+        ret = STB_SetTrRetryCount(inContext->handle, inRetryCount);
         if(STB_NORMAL != ret){
             break;
         }
 
-        ret = STB_SetTrSteadinessParam(m_Handle, inStbPosParam, inStbSizeParam);
+        ret = STB_SetTrSteadinessParam(inContext->handle, inStbPosParam, inStbSizeParam);
     }while(0);
 
     return ret;
 }
 
-int STB_SetPeParam(int inThreshold, int inUDAngleMin, int inUDAngleMax, int inLRAngleMin, int inLRAngleMax, int inCompCount)
+int STB_SetPeParam(STB_CONTEXT *inContext, int inThreshold, int inUDAngleMin, int inUDAngleMax, int inLRAngleMin, int inLRAngleMax, int inCompCount)
 {
     int ret;
+    if(NULL == inContext){
+        return STB_ERR_INVALIDPARAM;
+    }
     do{
-        ret = STB_SetPeThresholdUse(m_Handle, inThreshold);
+        ret = STB_SetPeThresholdUse(inContext->handle, inThreshold);
         if(STB_NORMAL != ret){
             break;
         }
 
-        ret = STB_SetPeAngleUse(m_Handle, inUDAngleMin, inUDAngleMax, inLRAngleMin, inLRAngleMax);
+        ret = STB_SetPeAngleUse(inContext->handle, inUDAngleMin, inUDAngleMax, inLRAngleMin, inLRAngleMax);
         if(STB_NORMAL != ret){
             break;
         }
 
-        ret = STB_SetPeCompleteFrameCount(m_Handle, inCompCount);
+        ret = STB_SetPeCompleteFrameCount(inContext->handle, inCompCount);
     }while(0);
 
     return ret;
 }
 
-int STB_SetFrParam(int inThreshold, int inUDAngleMin, int inUDAngleMax, int inLRAngleMin, int inLRAngleMax, int inCompCount, int inRatio)
+int STB_SetFrParam(STB_CONTEXT *inContext, int inThreshold, int inUDAngleMin, int inUDAngleMax, int inLRAngleMin, int inLRAngleMax, int inCompCount, int inRatio)
 {
     int ret;
+    if(NULL == inContext){
+        return STB_ERR_INVALIDPARAM;
+    }
     do{
-        ret = STB_SetFrThresholdUse(m_Handle, inThreshold);
+        ret = STB_SetFrThresholdUse(inContext->handle, inThreshold);
         if(STB_NORMAL != ret){
             break;
         }
 
-        ret = STB_SetFrAngleUse(m_Handle, inUDAngleMin, inUDAngleMax, inLRAngleMin, inLRAngleMax);
+        ret = STB_SetFrAngleUse(inContext->handle, inUDAngleMin, inUDAngleMax, inLRAngleMin, inLRAngleMax);
         if(STB_NORMAL != ret){
             break;
         }
 
-        ret = STB_SetFrCompleteFrameCount(m_Handle, inCompCount);
+        ret = STB_SetFrCompleteFrameCount(inContext->handle, inCompCount);
         if(STB_NORMAL != ret){
             break;
         }
 
-        ret = STB_SetFrMinRatio(m_Handle, inRatio);
+        ret = STB_SetFrMinRatio(inContext->handle, inRatio);
     }while(0);
 
     return ret;
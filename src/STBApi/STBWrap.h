@@ -31,18 +31,29 @@
 extern "C" {
 #endif
 
-int STB_Init(int inFuncFlag);
-void STB_Final(void);
+#define STB_MAX_NUM 35
 
-int STB_Exec(int inActiveFunc, const HVC_RESULT *inResult, int *pnSTBFaceCount, STB_FACE **pSTBFaceResult, int *pnSTBBodyCount, STB_BODY **pSTBBodyResult);
+/* STB context : one per sensor, contexts can be used from different threads */
+typedef struct {
+    HSTB        handle;
+    int         nFaceCount;
+    STB_FACE    face[STB_MAX_NUM];
+    int         nBodyCount;
+    STB_BODY    body[STB_MAX_NUM];
+} STB_CONTEXT;
 
-int STB_Clear(void);
+/* inContext must be zero cleared before the first STB_Init */
+int STB_Init(STB_CONTEXT *inContext, int inFuncFlag);
+void STB_Final(STB_CONTEXT *inContext);
 
-int STB_SetTrParam(int inRetryCount, int inStbPosParam, int inStbSizeParam);
-int STB_SetPeParam(int inThreshold, int inUDAngleMin, int inUDAngleMax, int inLRAngleMin, int inLRAngleMax, int inCompCount);
-int STB_SetFrParam(int inThreshold, int inUDAngleMin, int inUDAngleMax, int inLRAngleMin, int inLRAngleMax, int inCompCount, int inRatio);
+/* output results point into inContext, valid until next STB_Exec with the same context */
+int STB_Exec(STB_CONTEXT *inContext, int inActiveFunc, const HVC_RESULT *inResult, int *pnSTBFaceCount, STB_FACE **pSTBFaceResult, int *pnSTBBodyCount, STB_BODY **pSTBBodyResult);
 
-static void GetFrameResult(int inActiveFunc, const HVC_RESULT *inResult, STB_FRAME_RESULT *outFrameResult);
+int STB_Clear(STB_CONTEXT *inContext);
+
+int STB_SetTrParam(STB_CONTEXT *inContext, int inRetryCount, int inStbPosParam, int inStbSizeParam);
+int STB_SetPeParam(STB_CONTEXT *inContext, int inThreshold, int inUDAngleMin, int inUDAngleMax, int inLRAngleMin, int inLRAngleMax, int inCompCount);
+int STB_SetFrParam(STB_CONTEXT *inContext, int inThreshold, int inUDAngleMin, int inUDAngleMax, int inLRAngleMin, int inLRAngleMax, int inCompCount, int inRatio);
 
 #ifdef  __cplusplus
 }
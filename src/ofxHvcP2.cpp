@@ -17,6 +17,40 @@ ofxHvcP2::ofxHvcP2() {
 	execFlag = 0x0;
 	imageNo = HVC_EXECUTE_IMAGE_NONE;
 	initialized = false;
+	thumbnailEnabled = false;
+	bestShotEnabled = false;
+	progressiveImageEnabled = false;
+	progressiveImageRows = 24;
+	imageRows = 0;
+	resultProcessed = false;
+	frameUpdated = frameNew = false;
+	imageUpdated = imageNew = false;
+	privacyMaskEnabled = false;
+	privacyMaskBody = false;
+	motionGateEnabled = false;
+	motionIdle = false;
+	motionThreshold = 0.005f;
+	motionStillFrames = 5;
+	motionStillCount = 0;
+	idleModeEnabled = false;
+	idle = false;
+	idleEmptyFrames = 30;
+	idleEmptyCount = 0;
+	idleInterval = 1000;
+	powerState = FullDetection;
+	memset(powerTimes, 0, sizeof(powerTimes));
+	powerCycleTime = 0;
+	predictionEnabled = false;
+	faceFilterEnabled = false;
+	reIdentificationEnabled = false;
+	trajectoryEnabled = false;
+	pipelineEnabled = false;
+	hasPendingFrame = false;
+	droppedFrames = 0;
+	pipeline.setFinishedCallback([this] { startPipeline(); });
+	sendTime = 0;
+	latency = 0;
+	memset(&stbContext, 0, sizeof(stbContext));
 }
 
 
@@ -25,6 +59,24 @@ ofxHvcP2::~ofxHvcP2() {
 }
 
 void ofxHvcP2::setup(int _comPortNum) {
+	// STB initialize, before the HVC thread can use the context
+	int returnCode = STB_Init(&stbContext, STB_FUNC_BD | STB_FUNC_DT | STB_FUNC_PT | STB_FUNC_AG | STB_FUNC_GN | STB_FUNC_FR);
+	if (returnCode != 0) {
+		ofLogError() << "STB_Init Error : " << returnCode;
+	}
+	returnCode = STB_SetTrParam(&stbContext, STB_RETRYCOUNT_DEFAULT, STB_POSSTEADINESS_DEFAULT, STB_SIZESTEADINESS_DEFAULT);
+	if (returnCode != 0) {
+		ofLogError() << "HVCApi(STB_SetTrParam) Error : " << returnCode;
+	}
+	returnCode = STB_SetPeParam(&stbContext, STB_PE_THRESHOLD_DEFAULT, STB_PE_ANGLEUDMIN_DEFAULT, STB_PE_ANGLEUDMAX_DEFAULT, STB_PE_ANGLELRMIN_DEFAULT, STB_PE_ANGLELRMAX_DEFAULT, STB_PE_FRAME_DEFAULT);
+	if (returnCode != 0) {
+		ofLogError() << "HVCApi(STB_SetPeParam) Error : " << returnCode;
+	}
+	returnCode = STB_SetFrParam(&stbContext, STB_FR_THRESHOLD_DEFAULT, STB_FR_ANGLEUDMIN_DEFAULT, STB_FR_ANGLEUDMAX_DEFAULT, STB_FR_ANGLELRMIN_DEFAULT, STB_FR_ANGLELRMAX_DEFAULT, STB_FR_FRAME_DEFAULT, STB_FR_RATIO_DEFAULT);
+	if (returnCode != 0) {
+		ofLogError() << "HVCApi(STB_SetFrParam) Error : " << returnCode;
+	}
+
 	// serial port initialize
 	int comPortNum;
 	S_STAT serialStat;
@@ -39,20 +91,6 @@ void ofxHvcP2::setup(int _comPortNum) {
 		initialized = true;
 		ofAddListener(ofEvents().update, this, &ofxHvcP2::update);
 	}
-
-	// STB initialize
-	int returnCode = STB_Init(STB_FUNC_BD | STB_FUNC_DT | STB_FUNC_PT | STB_FUNC_AG | STB_FUNC_GN);
-	if (returnCode != 0) {
-		ofLogError() << "STB_Init Error : " << returnCode;
-	}
-	returnCode = STB_SetTrParam(STB_RETRYCOUNT_DEFAULT, STB_POSSTEADINESS_DEFAULT, STB_SIZESTEADINESS_DEFAULT);
-	if (returnCode != 0) {
-		ofLogError() << "HVCApi(STB_SetTrParam) Error : " << returnCode;
-	}
-	returnCode = STB_SetPeParam(STB_PE_THRESHOLD_DEFAULT, STB_PE_ANGLEUDMIN_DEFAULT, STB_PE_ANGLEUDMAX_DEFAULT, STB_PE_ANGLELRMIN_DEFAULT, STB_PE_ANGLELRMAX_DEFAULT, STB_PE_FRAME_DEFAULT);
-	if (returnCode != 0) {
-		ofLogError() << "HVCApi(STB_SetPeParam) Error : " << returnCode;
-	}
 }
 
 void ofxHvcP2::update(ofEventArgs & e) {
@@ -64,6 +102,14 @@ void ofxHvcP2::update(ofEventArgs & e) {
 		frameNew = false;
 	}
 
+	if (imageUpdated) {
+		imageNew = true;
+		imageUpdated = false;
+	}
+	else {
+		imageNew = false;
+	}
+
 	if (!initialized) {
 		startThread();
 		initialized = true;
@@ -72,10 +118,21 @@ void ofxHvcP2::update(ofEventArgs & e) {
 }
 
 void ofxHvcP2::close() {
+	// HVC thread uses the port and the STB context, stop it first
+	if (isThreadRunning()) {
+		waitForThread(true);
+	}
+	setActivePipeline(false);
+	if (bestShotEnabled) {
+		flushBestShots();
+	}
 	if (initialized) {
 		ofRemoveListener(ofEvents().update, this, &ofxHvcP2::update);
-		STB_Final();
 		com_close();
+		initialized = false;
+	}
+	if (stbContext.handle != NULL) {
+		STB_Final(&stbContext);
 	}
 }
 
@@ -96,9 +153,8 @@ void ofxHvcP2::threadedFunction() {
 	pHVCResult = new HVC_RESULT();
 
 	loopBreakFlag = false;
-	while (true) {
+	while (isThreadRunning()) {
 		loop();
-		frameUpdated = true;
 
 		if (loopBreakFlag) {
 			initialized = false;
@@ -112,7 +168,16 @@ void ofxHvcP2::loop() {
 	/* Execute Detection             */
 	/*********************************/
 	timeOutTime = 1000; // msec // UART_EXECUTE_TIMEOUT;
-	int ret = HVC_ExecuteEx(timeOutTime, execFlag, imageNo, pHVCResult, &status);
+	resultProcessed = false;
+	int rowStep = progressiveImageEnabled ? progressiveImageRows : 0;
+	updatePowerTime();
+	INT32 currentImageNo = getCurrentImageNo();
+	// rows of the new image are copied from the top
+	mutex.lock();
+	imageRows = 0;
+	mutex.unlock();
+	sendTime = ofGetElapsedTimeMillis();
+	int ret = HVC_ExecuteExProgress(timeOutTime, getCurrentExecFlag(), currentImageNo, pHVCResult, &status, &ofxHvcP2::progress, rowStep, this);
 	if (ret != 0) {
 		ofLogError() << "HVCApi(HVC_ExecuteEx) Error : " + ofToString(ret);
 		loopBreakFlag = true;
@@ -124,10 +189,50 @@ void ofxHvcP2::loop() {
 		return;
 	}
 
+	// result is usually processed in progress callback, before the image is received
+	if (!resultProcessed) {
+		processResult();
+	}
+	if (currentImageNo != HVC_EXECUTE_IMAGE_NONE) {
+		processImage();
+	}
+
+	// idle cadence. no detection runs while waiting, so the wait ends only after the interval,
+	// when idle mode is disabled, or when the thread is stopped
+	while (idleModeEnabled && idle && ofGetElapsedTimeMillis() < sendTime + idleInterval && isThreadRunning()) {
+		ofSleepMillis(10);
+	}
+}
+
+void ofxHvcP2::progress(INT32 event, INT32 rows, const HVC_RESULT *, void *userData) {
+	auto hvc = (ofxHvcP2 *)userData;
+	if (event == HVC_PROGRESS_RESULT) {
+		hvc->processResult();
+	}
+	else if (event == HVC_PROGRESS_IMAGE_ROWS) {
+		hvc->processImageRows(rows);
+	}
+}
+
+void ofxHvcP2::processResult() {
 	mutex.lock();
 
-	if (imageNo != HVC_EXECUTE_IMAGE_NONE) {
-		makeCapturedImage();
+	float currentLatency = ofGetElapsedTimeMillis() - sendTime;
+	latency = latency == 0 ? currentLatency : latency * 0.9f + currentLatency * 0.1f;
+
+	// privacy mask uses raw detection, before STB moves it
+	privacyRects.clear();
+	if (privacyMaskEnabled) {
+		for (int i = 0; i < pHVCResult->fdResult.num; ++i) {
+			auto &dt = pHVCResult->fdResult.fcResult[i].dtResult;
+			privacyRects.push_back(vec3i(dt.posX, dt.posY, dt.size));
+		}
+		if (privacyMaskBody && (pHVCResult->executedFunc & HVC_ACTIV_BODY_DETECTION)) {
+			for (int i = 0; i < pHVCResult->bdResult.num; ++i) {
+				auto &bd = pHVCResult->bdResult.bdResult[i];
+				privacyRects.push_back(vec3i(bd.posX, bd.posY, bd.size));
+			}
+		}
 	}
 
 	int nSTBFaceCount;
@@ -135,7 +240,7 @@ void ofxHvcP2::loop() {
 	int nSTBBodyCount;
 	STB_BODY *pSTBBodyResult;
 
-	if (STB_Exec(pHVCResult->executedFunc, pHVCResult, &nSTBFaceCount, &pSTBFaceResult, &nSTBBodyCount, &pSTBBodyResult) == 0) {
+	if (STB_Exec(&stbContext, pHVCResult->executedFunc, pHVCResult, &nSTBFaceCount, &pSTBFaceResult, &nSTBBodyCount, &pSTBBodyResult) == 0) {
 		for (int i = 0; i < nSTBBodyCount; i++) {
 			if (pHVCResult->bdResult.num <= i) break;
 
@@ -166,6 +271,13 @@ void ofxHvcP2::loop() {
 					pHVCResult->fdResult.fcResult[nIndex].genderResult.confidence += 10000; // Complete
 				}
 			}
+			if (pHVCResult->executedFunc & HVC_ACTIV_FACE_RECOGNITION) {
+				pHVCResult->fdResult.fcResult[nIndex].recognitionResult.confidence += 10000; // During
+				if (pSTBFaceResult[i].recognition.status >= STB_STATUS_COMPLETE) {
+					pHVCResult->fdResult.fcResult[nIndex].recognitionResult.uid = pSTBFaceResult[i].recognition.value;
+					pHVCResult->fdResult.fcResult[nIndex].recognitionResult.confidence += 10000; // Complete
+				}
+			}
 		}
 	}
 
@@ -214,12 +326,29 @@ void ofxHvcP2::loop() {
 			newHand.confidence = pHVCResult->hdResult.hdResult[i].confidence;
 		}
 
+		// hands are not tracked by STB
+		handTracker.beginFrame();
+		for (auto &h : hands) {
+			handTracker.addHand(h.position.x, h.position.y, h.size);
+		}
+		if (pHVCResult->executedFunc & HVC_ACTIV_BODY_DETECTION) {
+			for (auto &b : bodies) {
+				handTracker.addBody(b.trackingId, b.position.x, b.position.y, b.size);
+			}
+		}
+		handTracker.endFrame();
+		for (int i = 0; i < numHands; ++i) {
+			hands[i].trackingId = handTracker.getTrackingId(i);
+			hands[i].bodyTrackingId = handTracker.getBodyTrackingId(i);
+		}
+
 		// hand information debug print
 		if (debugPrint) {
 			if (debugPrint) cout << "hand count : " + ofToString(numHands) << endl;
 			for (int handIndex = 0; handIndex < hands.size(); ++handIndex) {
 				auto &h = hands[handIndex];
 				cout << "index:" << handIndex;
+				cout << "\ttrackingID:" << h.trackingId << "\tbodyTrackingID:" << h.bodyTrackingId;
 				cout << "\tpos:(" << h.position.x << ", " << h.position.y << ")\tsize:" << h.size << "\tconfidence:" << h.confidence << endl;
 				cout << endl;
 			}
@@ -299,6 +428,7 @@ void ofxHvcP2::loop() {
 				else {
 					newFace.gaze.x = pHVCResult->fdResult.fcResult[i].gazeResult.gazeLR;
 					newFace.gaze.y = pHVCResult->fdResult.fcResult[i].gazeResult.gazeUD;
+					newFace.hasGaze = true;
 				}
 			}
 			if (pHVCResult->executedFunc & HVC_ACTIV_BLINK_ESTIMATION) {
@@ -311,6 +441,7 @@ void ofxHvcP2::loop() {
 				else {
 					newFace.blinkL = pHVCResult->fdResult.fcResult[i].blinkResult.ratioL;
 					newFace.blinkR = pHVCResult->fdResult.fcResult[i].blinkResult.ratioR;
+					newFace.hasBlink = true;
 				}
 			}
 			if (pHVCResult->executedFunc & HVC_ACTIV_EXPRESSION_ESTIMATION) {
@@ -334,6 +465,21 @@ void ofxHvcP2::loop() {
 					}
 				}
 			}
+			if (pHVCResult->executedFunc & HVC_ACTIV_FACE_RECOGNITION) {
+				/* Face Recognition */
+				// -128 is not estimated, -1 is estimated but not registered
+				if (pHVCResult->fdResult.fcResult[i].recognitionResult.uid == -128) {
+					newFace.recognitionUid = -1;
+					newFace.recognitionScore = 0;
+					newFace.recognitionStbState = None;
+				}
+				else {
+					newFace.recognitionUid = MAX(pHVCResult->fdResult.fcResult[i].recognitionResult.uid, -1);
+					int confidence = pHVCResult->fdResult.fcResult[i].recognitionResult.confidence;
+					newFace.recognitionScore = MAX(getConfidenceWithoutStbState(confidence), 0);
+					newFace.recognitionStbState = getStbState(confidence);
+				}
+			}
 		}
 
 		// face information debug print
@@ -355,13 +501,160 @@ void ofxHvcP2::loop() {
 					cout << ' ' << i << ':' << f.expressionScore[i];
 				}
 				cout << endl << "\texpressionDegree:" << f.expressionDegree << endl;
+				cout << "\trecognition:" << f.recognitionUid << "\tscore:" << f.recognitionScore << endl;
 				cout << endl;
 			}
 			cout << endl;
 		}
 	}
 
+	if (faceFilterEnabled) {
+		updateFaceFilter();
+	}
+	if (idleModeEnabled) {
+		updateIdleMode();
+	}
+	merges.clear();
+	if (reIdentificationEnabled) {
+		updateReIdentification();
+	}
+	if (trajectoryEnabled) {
+		updateTrajectories();
+	}
+	if (predictionEnabled) {
+		updatePrediction();
+	}
+
+	// the latest frame for the pipeline, older one is dropped
+	if (pipelineEnabled) {
+		pipelineMutex.lock();
+		if (hasPendingFrame) ++droppedFrames;
+		pendingFrame.faces = faces;
+		pendingFrame.bodies = bodies;
+		pendingFrame.hands = hands;
+		pendingFrame.time = sendTime;
+		hasPendingFrame = true;
+		pipelineMutex.unlock();
+	}
+
+	mutex.unlock();
+
+	resultProcessed = true;
+	frameUpdated = true;
+
+	// notify outside of lock, listeners may call getter
+	for (auto &m : merges) {
+		ofNotifyEvent(reIdentifyEvent, m, this);
+	}
+
+	if (pipelineEnabled) {
+		startPipeline();
+	}
+}
+
+void ofxHvcP2::processImageRows(int rows) {
+	// masked image must be published after whole image is received
+	if (!progressiveImageEnabled || privacyMaskEnabled) return;
+
+	int width = pHVCResult->image.width;
+	int height = pHVCResult->image.height;
+	if (width == 0 || rows >= height) return;
+
+	mutex.lock();
+	if (capturePixels.getWidth() != width || capturePixels.getHeight() != height) {
+		capturePixels.clear();
+		capturePixels.allocate(width, height, ofImageType::OF_IMAGE_GRAYSCALE);
+		imageRows = 0;
+	}
+	int startRow = MIN(imageRows, rows);
+	memcpy(capturePixels.getData() + startRow * width, pHVCResult->image.image + startRow * width, (rows - startRow) * width);
+	capture.setFromPixels(capturePixels);
+	imageRows = rows;
+	mutex.unlock();
+
+	ofNotifyEvent(imageProgressEvent, rows, this);
+}
+
+void ofxHvcP2::processImage() {
+	mutex.lock();
+
+	if (motionGateEnabled) {
+		updateMotionGate();
+	}
+	// mask before anything reads the image
+	if (privacyMaskEnabled) {
+		applyPrivacyMask();
+	}
+	makeCapturedImage();
+	imageRows = pHVCResult->image.height;
+
+	lostShots.clear();
+	if (thumbnailEnabled || bestShotEnabled) {
+		makeThumbnails();
+		if (bestShotEnabled) {
+			updateBestShot();
+		}
+	}
+
 	mutex.unlock();
+
+	imageUpdated = true;
+
+	// notify outside of lock, listeners may call getter
+	if (progressiveImageEnabled) {
+		int rows = imageRows;
+		ofNotifyEvent(imageProgressEvent, rows, this);
+	}
+	for (auto &shot : lostShots) {
+		ofNotifyEvent(bestShotEvent, shot, this);
+	}
+}
+
+void ofxHvcP2::updateMotionGate() {
+	float score = motionDetector.update(pHVCResult->image.image, pHVCResult->image.width, pHVCResult->image.height);
+	int numDetections = pHVCResult->bdResult.num + pHVCResult->hdResult.num + pHVCResult->fdResult.num;
+
+	if (score >= motionThreshold || numDetections > 0) {
+		motionStillCount = 0;
+		motionIdle = false;
+	}
+	else if (++motionStillCount >= motionStillFrames) {
+		motionIdle = true;
+	}
+}
+
+void ofxHvcP2::updateIdleMode() {
+	int numDetections = pHVCResult->bdResult.num + pHVCResult->hdResult.num + pHVCResult->fdResult.num;
+
+	if (numDetections > 0) {
+		idleEmptyCount = 0;
+		idle = false;
+	}
+	else if (++idleEmptyCount >= idleEmptyFrames) {
+		idle = true;
+	}
+}
+
+void ofxHvcP2::updatePowerTime() {
+	// time of the last cycle goes to the state it ran in
+	uint64_t now = ofGetElapsedTimeMillis();
+	mutex.lock();
+	if (powerCycleTime != 0) {
+		powerTimes[powerState] += now - powerCycleTime;
+	}
+	powerCycleTime = now;
+	if (idleModeEnabled && idle) powerState = IdleDetection;
+	else if (motionGateEnabled && motionIdle && imageNo != HVC_EXECUTE_IMAGE_NONE) powerState = MotionGated;
+	else powerState = FullDetection;
+	mutex.unlock();
+}
+
+void ofxHvcP2::applyPrivacyMask() {
+	if (!privacyMask.begin(pHVCResult->image.image, pHVCResult->image.width, pHVCResult->image.height)) return;
+
+	for (auto &r : privacyRects) {
+		privacyMask.addRect(r.x, r.y, r.z);
+	}
 }
 
 void ofxHvcP2::makeCapturedImage() {
@@ -384,6 +677,138 @@ void ofxHvcP2::makeCapturedImage() {
 	capture.setFromPixels(capturePixels);
 }
 
+void ofxHvcP2::makeThumbnails() {
+	if (!thumbnails.begin(pHVCResult->image.image, pHVCResult->image.width, pHVCResult->image.height)) return;
+
+	if (pHVCResult->executedFunc & HVC_ACTIV_FACE_DETECTION) {
+		for (int i = 0; i < faces.size(); ++i) {
+			auto &f = faces[i];
+			thumbnails.addFace(i, f.trackingId, f.position.x, f.position.y, f.size);
+		}
+	}
+	if (pHVCResult->executedFunc & HVC_ACTIV_BODY_DETECTION) {
+		for (int i = 0; i < bodies.size(); ++i) {
+			auto &b = bodies[i];
+			thumbnails.addBody(i, b.trackingId, b.position.x, b.position.y, b.size);
+		}
+	}
+}
+
+void ofxHvcP2::updateBestShot() {
+	if (!(pHVCResult->executedFunc & HVC_ACTIV_FACE_DETECTION)) return;
+
+	bool hasDirection = (pHVCResult->executedFunc & HVC_ACTIV_FACE_DIRECTION) != 0;
+	bestShot.beginFrame(ofGetElapsedTimeMillis());
+	for (int i = 0; i < thumbnails.getNumTiles(); ++i) {
+		auto &tile = thumbnails.getTile(i);
+		if (tile.type != ofxHvcP2ThumbnailAtlas::FaceTile) continue;
+
+		auto &f = faces[tile.index];
+		bestShot.addFace(f.trackingId, f.confidence, hasDirection, f.direction.z, f.direction.x, f.size,
+			thumbnails.getTileData(i), tile.width, tile.height);
+	}
+	bestShot.endFrame();
+	lostShots = bestShot.getLostShots();
+}
+
+void ofxHvcP2::updatePrediction() {
+	// device captures right after receiving the command
+	if (pHVCResult->executedFunc & HVC_ACTIV_FACE_DETECTION) {
+		faceMotion.beginFrame(sendTime);
+		for (auto &f : faces) {
+			faceMotion.update(f.trackingId, f.position.x, f.position.y, f.size);
+		}
+		faceMotion.endFrame();
+	}
+	if (pHVCResult->executedFunc & HVC_ACTIV_BODY_DETECTION) {
+		bodyMotion.beginFrame(sendTime);
+		for (auto &b : bodies) {
+			bodyMotion.update(b.trackingId, b.position.x, b.position.y, b.size);
+		}
+		bodyMotion.endFrame();
+	}
+}
+
+void ofxHvcP2::updateFaceFilter() {
+	INT32 flag = pHVCResult->executedFunc;
+	if (!(flag & HVC_ACTIV_FACE_DETECTION)) return;
+
+	faceFilter.beginFrame(sendTime);
+	for (auto &f : faces) {
+		ofxHvcP2FaceFilter::Sample sample;
+		sample.confidence = f.confidence;
+		sample.hasDirection = (flag & HVC_ACTIV_FACE_DIRECTION) != 0;
+		sample.pitch = f.direction.x;
+		sample.roll = f.direction.y;
+		sample.yaw = f.direction.z;
+		// not estimated values are 0, they must not pull the filters
+		sample.hasGaze = f.hasGaze;
+		sample.gazeLR = f.gaze.x;
+		sample.gazeUD = f.gaze.y;
+		sample.hasBlink = f.hasBlink;
+		sample.blinkL = f.blinkL;
+		sample.blinkR = f.blinkR;
+		sample.hasExpression = (flag & HVC_ACTIV_EXPRESSION_ESTIMATION) != 0 && f.expression != UnknownExpression;
+		for (int i = 0; i < ofxHvcP2FaceFilter::numExpressions; ++i) {
+			sample.expressionScore[i] = f.expressionScore[i];
+		}
+		faceFilter.update(f.trackingId, sample, f.filtered);
+	}
+	faceFilter.endFrame();
+}
+
+void ofxHvcP2::updateReIdentification() {
+	INT32 flag = pHVCResult->executedFunc;
+	if (!(flag & HVC_ACTIV_FACE_DETECTION)) return;
+
+	reIdentifier.beginFrame(sendTime);
+	for (auto &f : faces) {
+		// only stabilized values are reliable enough to join tracks
+		int uid = -1, age = -1, gender = -1;
+		if ((flag & HVC_ACTIV_FACE_RECOGNITION) && f.recognitionStbState == Complete) uid = f.recognitionUid;
+		if ((flag & HVC_ACTIV_AGE_ESTIMATION) && f.ageStbState == Complete) age = f.age;
+		if ((flag & HVC_ACTIV_GENDER_ESTIMATION) && f.genderStbState == Complete) gender = f.gender == Male ? 1 : 0;
+		f.identity = reIdentifier.addFace(f.trackingId, uid, f.position.x, f.position.y, f.size, age, gender);
+	}
+	reIdentifier.endFrame();
+	merges = reIdentifier.getMerges();
+}
+
+void ofxHvcP2::updateTrajectories() {
+	if (!(pHVCResult->executedFunc & HVC_ACTIV_FACE_DETECTION)) return;
+
+	trajectories.beginFrame(sendTime);
+	for (auto &f : faces) {
+		ofxHvcP2TrajectoryStore::Observation o;
+		o.time = sendTime;
+		o.x = f.position.x;
+		o.y = f.position.y;
+		o.size = f.size;
+		if (pHVCResult->executedFunc & HVC_ACTIV_FACE_DIRECTION) {
+			o.pitch = f.direction.x;
+			o.roll = f.direction.y;
+			o.yaw = f.direction.z;
+		}
+		if (pHVCResult->executedFunc & HVC_ACTIV_GAZE_ESTIMATION) {
+			o.gazeLR = f.gaze.x;
+			o.gazeUD = f.gaze.y;
+		}
+		trajectories.add(f.trackingId, o);
+	}
+	trajectories.endFrame();
+}
+
+void ofxHvcP2::startPipeline() {
+	// called from the HVC thread and from the worker which finished the last run
+	pipelineMutex.lock();
+	if (pipelineEnabled && hasPendingFrame && !pipeline.isBusy()) {
+		std::swap(pipelineFrame, pendingFrame);
+		hasPendingFrame = false;
+		pipeline.start();
+	}
+	pipelineMutex.unlock();
+}
+
 void ofxHvcP2::setExecFlag(INT32 flag, bool enable) {
 	if (enable) execFlag = execFlag | flag;
 	else execFlag = execFlag & (~flag);
@@ -393,6 +818,25 @@ bool ofxHvcP2::getExecFlag(INT32 flag) {
 	return (execFlag & flag) == flag;
 }
 
+INT32 ofxHvcP2::getCurrentExecFlag() {
+	if (powerState == IdleDetection) {
+		return HVC_ACTIV_BODY_DETECTION;
+	}
+	// motion gate needs image to wake up
+	if (powerState == MotionGated) {
+		// cheapest detection in the configured flags
+		const INT32 idleCandidates[] = { HVC_ACTIV_FACE_DETECTION, HVC_ACTIV_BODY_DETECTION, HVC_ACTIV_HAND_DETECTION };
+		for (auto flag : idleCandidates) {
+			if (execFlag & flag) return flag;
+		}
+	}
+	return execFlag;
+}
+
+INT32 ofxHvcP2::getCurrentImageNo() {
+	return powerState == IdleDetection ? HVC_EXECUTE_IMAGE_NONE : imageNo;
+}
+
 void ofxHvcP2::setActiveBody(bool enable) { setExecFlag(HVC_ACTIV_BODY_DETECTION, enable); }
 void ofxHvcP2::setActiveHand(bool enable) { setExecFlag(HVC_ACTIV_HAND_DETECTION, enable); }
 void ofxHvcP2::setActiveFace(bool enable) { setExecFlag(HVC_ACTIV_FACE_DETECTION, enable); }
@@ -402,6 +846,7 @@ void ofxHvcP2::setActiveGender(bool enable) {	setExecFlag(HVC_ACTIV_GENDER_ESTIM
 void ofxHvcP2::setActiveGaze(bool enable) {	setExecFlag(HVC_ACTIV_GAZE_ESTIMATION, enable);}
 void ofxHvcP2::setActiveBlink(bool enable) {	setExecFlag(HVC_ACTIV_BLINK_ESTIMATION, enable);}
 void ofxHvcP2::setActiveExpression(bool enable) {	setExecFlag(HVC_ACTIV_EXPRESSION_ESTIMATION, enable);}
+void ofxHvcP2::setActiveRecognition(bool enable) {	setExecFlag(HVC_ACTIV_FACE_RECOGNITION, enable);}
 void ofxHvcP2::setImageSize(ImageSize imageSize) {
 	switch (imageSize) {
 	case NoImage: imageNo = HVC_EXECUTE_IMAGE_NONE; break;
@@ -419,6 +864,7 @@ bool ofxHvcP2::getActiveGender() { return getExecFlag(HVC_ACTIV_GENDER_ESTIMATIO
 bool ofxHvcP2::getActiveGaze() { return getExecFlag(HVC_ACTIV_GAZE_ESTIMATION); }
 bool ofxHvcP2::getActiveBlink() { return getExecFlag(HVC_ACTIV_BLINK_ESTIMATION); }
 bool ofxHvcP2::getActiveExpression() { return getExecFlag(HVC_ACTIV_EXPRESSION_ESTIMATION); }
+bool ofxHvcP2::getActiveRecognition() { return getExecFlag(HVC_ACTIV_FACE_RECOGNITION); }
 ofxHvcP2::ImageSize ofxHvcP2::getImageSize() {
 	return (ImageSize)imageNo;
 }
@@ -427,6 +873,301 @@ void ofxHvcP2::setActiveDebugPrint(bool enable) {
 	debugPrint = enable;
 }
 
+void ofxHvcP2::setActiveThumbnail(bool enable) {
+	thumbnailEnabled = enable;
+}
+
+bool ofxHvcP2::getActiveThumbnail() {
+	return thumbnailEnabled;
+}
+
+void ofxHvcP2::setActiveBestShot(bool enable) {
+	if (!enable && bestShotEnabled) {
+		flushBestShots();
+	}
+	mutex.lock();
+	bestShotEnabled = enable;
+	mutex.unlock();
+}
+
+void ofxHvcP2::flushBestShots() {
+	// tracks still in view are treated as lost, so their best shots are not dropped
+	mutex.lock();
+	bestShot.flush();
+	vector<ofxHvcP2BestShot::Shot> shots = bestShot.getLostShots();
+	bestShot.clear();
+	mutex.unlock();
+
+	for (auto &shot : shots) {
+		ofNotifyEvent(bestShotEvent, shot, this);
+	}
+}
+
+bool ofxHvcP2::getActiveBestShot() {
+	return bestShotEnabled;
+}
+
+void ofxHvcP2::setActiveProgressiveImage(bool enable, int rowStep) {
+	progressiveImageRows = MAX(rowStep, 1);
+	progressiveImageEnabled = enable;
+}
+
+bool ofxHvcP2::getActiveProgressiveImage() {
+	return progressiveImageEnabled;
+}
+
+void ofxHvcP2::setActivePrivacyMask(bool enable) {
+	privacyMaskEnabled = enable;
+}
+
+bool ofxHvcP2::getActivePrivacyMask() {
+	return privacyMaskEnabled;
+}
+
+void ofxHvcP2::setPrivacyMaskMode(ofxHvcP2PrivacyMask::Mode mode) {
+	mutex.lock();
+	privacyMask.setMode(mode);
+	mutex.unlock();
+}
+
+void ofxHvcP2::setPrivacyMaskStrength(float ratio) {
+	mutex.lock();
+	privacyMask.setStrength(ratio);
+	mutex.unlock();
+}
+
+void ofxHvcP2::setPrivacyMaskBody(bool enable) {
+	privacyMaskBody = enable;
+}
+
+void ofxHvcP2::setActiveMotionGate(bool enable) {
+	mutex.lock();
+	motionGateEnabled = enable;
+	motionIdle = false;
+	motionStillCount = 0;
+	motionDetector.reset();
+	mutex.unlock();
+}
+
+bool ofxHvcP2::getActiveMotionGate() {
+	return motionGateEnabled;
+}
+
+void ofxHvcP2::setMotionGateThreshold(float score, int stillFrames) {
+	motionThreshold = score;
+	motionStillFrames = MAX(stillFrames, 1);
+}
+
+float ofxHvcP2::getMotionScore() {
+	mutex.lock();
+	float score = motionDetector.getScore();
+	mutex.unlock();
+	return score;
+}
+
+void ofxHvcP2::getMotionRects(vector<ofRectangle> &out) {
+	mutex.lock();
+	out = motionDetector.getRects();
+	mutex.unlock();
+}
+
+bool ofxHvcP2::isMotionIdle() {
+	return motionIdle;
+}
+
+void ofxHvcP2::setActiveIdleMode(bool enable) {
+	mutex.lock();
+	idleModeEnabled = enable;
+	idle = false;
+	idleEmptyCount = 0;
+	mutex.unlock();
+}
+
+bool ofxHvcP2::getActiveIdleMode() {
+	return idleModeEnabled;
+}
+
+void ofxHvcP2::setIdleModeThreshold(int emptyFrames, uint64_t interval) {
+	idleEmptyFrames = MAX(emptyFrames, 1);
+	idleInterval = interval;
+}
+
+ofxHvcP2::PowerState ofxHvcP2::getPowerState() {
+	return powerState;
+}
+
+uint64_t ofxHvcP2::getPowerTime(PowerState state) {
+	if (state < 0 || state >= PowerStateNum) return 0;
+	mutex.lock();
+	uint64_t value = powerTimes[state];
+	mutex.unlock();
+	return value;
+}
+
+void ofxHvcP2::resetPowerTimes() {
+	mutex.lock();
+	memset(powerTimes, 0, sizeof(powerTimes));
+	mutex.unlock();
+}
+
+void ofxHvcP2::setActiveFaceFilter(bool enable) {
+	mutex.lock();
+	if (!enable) {
+		faceFilter.clear();
+	}
+	faceFilterEnabled = enable;
+	mutex.unlock();
+}
+
+bool ofxHvcP2::getActiveFaceFilter() {
+	return faceFilterEnabled;
+}
+
+void ofxHvcP2::setFaceFilterAngle(float minCutoff, float beta) {
+	mutex.lock();
+	faceFilter.setAngleFilter(minCutoff, beta);
+	mutex.unlock();
+}
+
+void ofxHvcP2::setFaceFilterExpressionHysteresis(float margin) {
+	mutex.lock();
+	faceFilter.setExpressionHysteresis(margin);
+	mutex.unlock();
+}
+
+void ofxHvcP2::setActiveReIdentification(bool enable) {
+	mutex.lock();
+	if (!enable) {
+		reIdentifier.clear();
+	}
+	reIdentificationEnabled = enable;
+	mutex.unlock();
+}
+
+bool ofxHvcP2::getActiveReIdentification() {
+	return reIdentificationEnabled;
+}
+
+void ofxHvcP2::setReIdentificationMaxGap(uint64_t millis) {
+	mutex.lock();
+	reIdentifier.setMaxGap(millis);
+	mutex.unlock();
+}
+
+void ofxHvcP2::setActiveTrajectory(bool enable, int capacity) {
+	mutex.lock();
+	if (enable && capacity != trajectories.getCapacity()) {
+		trajectories.setCapacity(capacity);
+	}
+	else if (!enable) {
+		trajectories.clear();
+	}
+	trajectoryEnabled = enable;
+	mutex.unlock();
+}
+
+bool ofxHvcP2::getActiveTrajectory() {
+	return trajectoryEnabled;
+}
+
+const ofxHvcP2TrajectoryStore &ofxHvcP2::getTrajectories() {
+	return trajectories;
+}
+
+void ofxHvcP2::setActivePipeline(bool enable, int numWorkers) {
+	// no new run is started after this
+	pipelineMutex.lock();
+	pipelineEnabled = false;
+	hasPendingFrame = false;
+	pipelineMutex.unlock();
+
+	if (enable) {
+		pipeline.setup(numWorkers);
+		pipelineMutex.lock();
+		pipelineEnabled = true;
+		pipelineMutex.unlock();
+	}
+	else {
+		pipeline.stop();
+	}
+}
+
+bool ofxHvcP2::getActivePipeline() {
+	return pipelineEnabled;
+}
+
+int ofxHvcP2::addStage(const string &name, std::function<void(const Frame &)> func, const vector<int> &dependencies) {
+	if (pipelineEnabled || !func) return -1;
+	// stages read the frame of the current run, it is not replaced while running
+	return pipeline.addStage(name, [this, func] { func(pipelineFrame); }, dependencies);
+}
+
+void ofxHvcP2::getStageTimings(vector<ofxHvcP2Pipeline::Timing> &out) {
+	pipeline.getTimings(out);
+}
+
+int ofxHvcP2::getDroppedFrames() {
+	pipelineMutex.lock();
+	int value = droppedFrames;
+	pipelineMutex.unlock();
+	return value;
+}
+
+void ofxHvcP2::setActivePrediction(bool enable) {
+	mutex.lock();
+	if (!enable) {
+		faceMotion.clear();
+		bodyMotion.clear();
+	}
+	predictionEnabled = enable;
+	mutex.unlock();
+}
+
+bool ofxHvcP2::getActivePrediction() {
+	return predictionEnabled;
+}
+
+bool ofxHvcP2::predictFace(int trackingId, uint64_t time, ofVec3f &out) {
+	mutex.lock();
+	bool found = faceMotion.predict(trackingId, time, out);
+	mutex.unlock();
+	return found;
+}
+
+bool ofxHvcP2::predictFace(int trackingId, ofVec3f &out) {
+	return predictFace(trackingId, ofGetElapsedTimeMillis(), out);
+}
+
+bool ofxHvcP2::predictBody(int trackingId, uint64_t time, ofVec3f &out) {
+	mutex.lock();
+	bool found = bodyMotion.predict(trackingId, time, out);
+	mutex.unlock();
+	return found;
+}
+
+bool ofxHvcP2::predictBody(int trackingId, ofVec3f &out) {
+	return predictBody(trackingId, ofGetElapsedTimeMillis(), out);
+}
+
+float ofxHvcP2::getLatency() {
+	mutex.lock();
+	float l = latency;
+	mutex.unlock();
+	return l;
+}
+
+void ofxHvcP2::setFaceThumbnailSize(int width, int height) {
+	mutex.lock();
+	thumbnails.setFaceTileSize(width, height);
+	mutex.unlock();
+}
+
+void ofxHvcP2::setBodyThumbnailSize(int width, int height) {
+	mutex.lock();
+	thumbnails.setBodyTileSize(width, height);
+	mutex.unlock();
+}
+
 void ofxHvcP2::getBodies(Bodies &out) {
 	mutex.lock();
 	out = bodies;
@@ -449,10 +1190,24 @@ ofImage & ofxHvcP2::getImage() {
 	return capture;
 }
 
+void ofxHvcP2::getThumbnails(ofxHvcP2ThumbnailAtlas &out) {
+	mutex.lock();
+	thumbnails.copyTiles(out);
+	mutex.unlock();
+}
+
 bool ofxHvcP2::isFrameNew() {
 	return frameNew;
 }
 
+bool ofxHvcP2::isImageNew() {
+	return imageNew;
+}
+
+int ofxHvcP2::getImageRows() {
+	return imageRows;
+}
+
 bool ofxHvcP2::isInitialized() {
 	return initialized;
 }
@@ -5,6 +5,16 @@
 #include "HVCApi/HVCDef.h"
 #include "HVCApi/HVCExtraUartFunc.h"
 #include "STBApi/STBWrap.h"
+#include "ofxHvcP2ThumbnailAtlas.h"
+#include "ofxHvcP2BestShot.h"
+#include "ofxHvcP2PrivacyMask.h"
+#include "ofxHvcP2MotionDetector.h"
+#include "ofxHvcP2MotionModel.h"
+#include "ofxHvcP2HandTracker.h"
+#include "ofxHvcP2FaceFilter.h"
+#include "ofxHvcP2ReIdentifier.h"
+#include "ofxHvcP2TrajectoryStore.h"
+#include "ofxHvcP2Pipeline.h"
 
 #define LOGBUFFERSIZE   8192
 
@@ -38,6 +48,13 @@
 #define STB_PE_ANGLELRMIN_DEFAULT          -20            /* Left/Right face angle minimum value for property estimation in STB */
 #define STB_PE_ANGLELRMAX_DEFAULT           20            /* Left/Right face angle maximum value for property estimation in STB */
 #define STB_PE_THRESHOLD_DEFAULT           300            /* Threshold for property estimation in STB */
+#define STB_FR_FRAME_DEFAULT                 5            /* Complete Frame Count for recognition in STB */
+#define STB_FR_RATIO_DEFAULT                60            /* Account Ratio for recognition in STB */
+#define STB_FR_ANGLEUDMIN_DEFAULT          -15            /* Up/Down face angle minimum value for recognition in STB */
+#define STB_FR_ANGLEUDMAX_DEFAULT           20            /* Up/Down face angle maximum value for recognition in STB */
+#define STB_FR_ANGLELRMIN_DEFAULT          -20            /* Left/Right face angle minimum value for recognition in STB */
+#define STB_FR_ANGLELRMAX_DEFAULT           20            /* Left/Right face angle maximum value for recognition in STB */
+#define STB_FR_THRESHOLD_DEFAULT           300            /* Threshold for recognition in STB */
 
 class ofxHvcP2 : public ofThread {
 public:
@@ -77,6 +94,13 @@ public:
 		Complete
 	};
 
+	enum PowerState {
+		FullDetection, // configured flags
+		MotionGated,   // cheapest configured detection (setActiveMotionGate)
+		IdleDetection, // body detection only, throttled (setActiveIdleMode)
+		PowerStateNum
+	};
+
 	struct vec2i {
 		int x, y;
 		vec2i() : x(0), y(0) {}
@@ -110,6 +134,8 @@ public:
 	};
 
 	struct Hand {
+		int trackingId = -1;
+		int bodyTrackingId = -1; // nearest tracked body
 		int confidence;
 		vec2i position;
 		int size;
@@ -124,15 +150,24 @@ public:
 		int directionConfidence;
 		int age;
 		int ageConfidence;
-		StbState ageStbState;
+		StbState ageStbState = None;
 		Gender gender;
 		int genderConfidence;
-		StbState genderStbState;
+		StbState genderStbState = None;
 		vec2i gaze;
-		int blinkL, blinkR;
-		Expression expression;
+		bool hasGaze = false; // false if gaze is not active or not estimated (gaze is 0)
+		int blinkL = 0, blinkR = 0;
+		bool hasBlink = false; // false if blink is not active or not estimated (blink is 0)
+		Expression expression = UnknownExpression;
 		int expressionScore[ExpressionNum - 1];
 		int expressionDegree;
+		int recognitionUid = -1; // -1 if unknown, or not registered when recognitionStbState is Complete
+		int recognitionScore;
+		StbState recognitionStbState = None;
+		// tracking ID of the first track of the person (setActiveReIdentification)
+		int identity = -1;
+		// stabilized by tracking ID (setActiveFaceFilter)
+		ofxHvcP2FaceFilter::Result filtered;
 	};
 
 	typedef vector<Body> Bodies;
@@ -143,6 +178,8 @@ public:
 private:
 	void setExecFlag(INT32, bool);
 	bool getExecFlag(INT32);
+	INT32 getCurrentExecFlag();
+	INT32 getCurrentImageNo();
 public:
 	void setActiveBody(bool enable);
 	void setActiveHand(bool enable);
@@ -153,6 +190,7 @@ public:
 	void setActiveGaze(bool enable);
 	void setActiveBlink(bool enable);
 	void setActiveExpression(bool enable);
+	void setActiveRecognition(bool enable);
 	void setImageSize(ImageSize imageSize);
 
 	bool getActiveBody();
@@ -164,17 +202,121 @@ public:
 	bool getActiveGaze();
 	bool getActiveBlink();
 	bool getActiveExpression();
+	bool getActiveRecognition();
 	ImageSize getImageSize();
 	void setActiveDebugPrint(bool enable);
 
+	// detection result is always published before the image is received.
+	// if enabled, image is also published every rowStep rows while receiving
+	// (not while privacy mask is active). imageProgressEvent gives received rows.
+	void setActiveProgressiveImage(bool enable, int rowStep = 24);
+	bool getActiveProgressiveImage();
+	ofEvent<int> imageProgressEvent;
+
+	// face and body thumbnails (need image)
+	void setActiveThumbnail(bool enable);
+	bool getActiveThumbnail();
+	void setFaceThumbnailSize(int width, int height);
+	void setBodyThumbnailSize(int width, int height);
+
+	// best face thumbnail per tracking ID (need image)
+	// bestShotEvent is notified from the HVC thread when the track is lost,
+	// and for the tracks in view when best shot is disabled or closed (from the calling thread)
+	void setActiveBestShot(bool enable);
+	bool getActiveBestShot();
+	ofEvent<ofxHvcP2BestShot::Shot> bestShotEvent;
+
+	// blur or pixelate faces (and bodies) before the image is published
+	// thumbnails and best shots are also masked
+	void setActivePrivacyMask(bool enable);
+	bool getActivePrivacyMask();
+	void setPrivacyMaskMode(ofxHvcP2PrivacyMask::Mode mode);
+	void setPrivacyMaskStrength(float ratio);
+	void setPrivacyMaskBody(bool enable);
+
+	// host side motion detection (need image, QVGA_HALF is enough)
+	// while nothing moves and nothing is detected, only the cheapest detection runs
+	void setActiveMotionGate(bool enable);
+	bool getActiveMotionGate();
+	void setMotionGateThreshold(float score, int stillFrames);
+	float getMotionScore();
+	void getMotionRects(vector<ofRectangle> &out);
+	bool isMotionIdle();
+
+	// after emptyFrames frames without detection, only body detection runs, without image,
+	// at most once per interval (millis). the first detection returns to the configured flags.
+	// idle has priority over the motion gate.
+	void setActiveIdleMode(bool enable);
+	bool getActiveIdleMode();
+	void setIdleModeThreshold(int emptyFrames, uint64_t interval);
+	PowerState getPowerState();
+	// time spent in each state since setup or resetPowerTimes (millis)
+	uint64_t getPowerTime(PowerState state);
+	void resetPowerTimes();
+
+	// constant velocity Kalman filter per tracking ID
+	// positions are extrapolated from the time the command was sent,
+	// so the acquisition latency is compensated. time is elapsed millis.
+	void setActivePrediction(bool enable);
+	bool getActivePrediction();
+	bool predictFace(int trackingId, uint64_t time, ofVec3f &out);
+	bool predictFace(int trackingId, ofVec3f &out);
+	bool predictBody(int trackingId, uint64_t time, ofVec3f &out);
+	bool predictBody(int trackingId, ofVec3f &out);
+	// time from sending the command to receiving the detection result (millis, smoothed)
+	float getLatency();
+
+	// temporal filters of direction, gaze, blink, expression and confidence per tracking ID
+	// results are in Face::filtered
+	void setActiveFaceFilter(bool enable);
+	bool getActiveFaceFilter();
+	void setFaceFilterAngle(float minCutoff, float beta);
+	void setFaceFilterExpressionHysteresis(float margin);
+
+	// join a new track to a recently lost track of the same person
+	// by recognition UID, or by position and attributes. result is Face::identity.
+	// reIdentifyEvent is notified from the HVC thread when tracks are joined.
+	void setActiveReIdentification(bool enable);
+	bool getActiveReIdentification();
+	void setReIdentificationMaxGap(uint64_t millis);
+	ofEvent<ofxHvcP2ReIdentifier::Merge> reIdentifyEvent;
+
+	// last observations of each face track. the store can be read from any thread without lock.
+	// capacity is observations per track (max ofxHvcP2TrajectoryStore::maxCapacity), changing it clears the store.
+	void setActiveTrajectory(bool enable, int capacity = 64);
+	bool getActiveTrajectory();
+	const ofxHvcP2TrajectoryStore &getTrajectories();
+
+	// stages run on a worker pool after each frame, not on the HVC thread, so they do not
+	// delay the next detection. stages without dependency between them run in parallel.
+	// if the stages are still running when a frame arrives, only the latest frame waits.
+	struct Frame {
+		Faces faces;
+		Bodies bodies;
+		Hands hands;
+		uint64_t time = 0; // elapsed millis when the command was sent
+	};
+	void setActivePipeline(bool enable, int numWorkers = 2);
+	bool getActivePipeline();
+	// add stages before setActivePipeline(true). return index, -1 if invalid
+	int addStage(const string &name, std::function<void(const Frame &)> func, const vector<int> &dependencies = vector<int>());
+	void getStageTimings(vector<ofxHvcP2Pipeline::Timing> &out);
+	// frames replaced by a newer frame while the stages were running
+	int getDroppedFrames();
+
 	// getter
 	void getBodies(Bodies &out);
 	void getHands(Hands &out);
 	void getFaces(Faces &out);
 	ofImage &getImage();
+	void getThumbnails(ofxHvcP2ThumbnailAtlas &out);
 
 	// if frame updated, return true
 	bool isFrameNew();
+	// if whole image updated, return true
+	bool isImageNew();
+	// received rows of current image
+	int getImageRows();
 
 	bool isInitialized();
 
@@ -205,19 +347,83 @@ private:
 
 	void threadedFunction();
 	void loop();
-
+	static void progress(INT32 event, INT32 rows, const HVC_RESULT *result, void *userData);
+	void processResult();
+	void processImageRows(int rows);
+	void processImage();
+
+	void updateMotionGate();
+	void updateIdleMode();
+	void updatePowerTime();
+	void applyPrivacyMask();
 	void makeCapturedImage();
+	void makeThumbnails();
+	void updateBestShot();
+	void flushBestShots();
+	void updatePrediction();
+	void updateFaceFilter();
+	void updateReIdentification();
+	void updateTrajectories();
+	void startPipeline();
 
 	bool loopBreakFlag;
 
 	int comPortNum;
+	STB_CONTEXT stbContext;
 	Bodies bodies;
 	Hands hands;
+	ofxHvcP2HandTracker handTracker;
 	Faces faces;
 	ofImage capture;
 	ofPixels capturePixels;
+	ofxHvcP2ThumbnailAtlas thumbnails;
+	bool thumbnailEnabled;
+	ofxHvcP2BestShot bestShot;
+	bool bestShotEnabled;
+	vector<ofxHvcP2BestShot::Shot> lostShots;
+	ofxHvcP2PrivacyMask privacyMask;
+	bool privacyMaskEnabled;
+	bool privacyMaskBody;
+	vector<vec3i> privacyRects;
+	ofxHvcP2MotionDetector motionDetector;
+	bool motionGateEnabled;
+	bool motionIdle;
+	float motionThreshold;
+	int motionStillFrames;
+	int motionStillCount;
+	bool idleModeEnabled;
+	bool idle;
+	int idleEmptyFrames;
+	int idleEmptyCount;
+	uint64_t idleInterval;
+	PowerState powerState;
+	uint64_t powerTimes[PowerStateNum];
+	uint64_t powerCycleTime;
+	ofxHvcP2MotionModel faceMotion;
+	ofxHvcP2MotionModel bodyMotion;
+	bool predictionEnabled;
+	ofxHvcP2FaceFilter faceFilter;
+	bool faceFilterEnabled;
+	ofxHvcP2ReIdentifier reIdentifier;
+	bool reIdentificationEnabled;
+	vector<ofxHvcP2ReIdentifier::Merge> merges;
+	ofxHvcP2TrajectoryStore trajectories;
+	bool trajectoryEnabled;
+	ofxHvcP2Pipeline pipeline;
+	std::atomic<bool> pipelineEnabled; // read by the HVC thread without lock
+	ofMutex pipelineMutex;
+	Frame pipelineFrame, pendingFrame;
+	bool hasPendingFrame;
+	int droppedFrames;
+	uint64_t sendTime;
+	float latency;
 
 	bool frameUpdated, frameNew;
+	bool imageUpdated, imageNew;
+	bool resultProcessed;
+	bool progressiveImageEnabled;
+	int progressiveImageRows;
+	int imageRows;
 	bool initialized;
 	ofMutex mutex;
 	bool debugPrint;
@@ -0,0 +1,264 @@
+#include "ofxHvcP2Annotator.h"
+
+// 5x7 font of ASCII 0x20-0x7e, 5 columns per glyph, bit 0 is the top row
+static const unsigned char font5x7[95][5] = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+	{ 0x00, 0x00, 0x5f, 0x00, 0x00 }, // !
+	{ 0x00, 0x07, 0x00, 0x07, 0x00 }, // "
+	{ 0x14, 0x7f, 0x14, 0x7f, 0x14 }, // #
+	{ 0x24, 0x2a, 0x7f, 0x2a, 0x12 }, // $
+	{ 0x23, 0x13, 0x08, 0x64, 0x62 }, // %
+	{ 0x36, 0x49, 0x55, 0x22, 0x50 }, // &
+	{ 0x00, 0x05, 0x03, 0x00, 0x00 }, // '
+	{ 0x00, 0x1c, 0x22, 0x41, 0x00 }, // (
+	{ 0x00, 0x41, 0x22, 0x1c, 0x00 }, // )
+	{ 0x08, 0x2a, 0x1c, 0x2a, 0x08 }, // *
+	{ 0x08, 0x08, 0x3e, 0x08, 0x08 }, // +
+	{ 0x00, 0x50, 0x30, 0x00, 0x00 }, // ,
+	{ 0x08, 0x08, 0x08, 0x08, 0x08 }, // -
+	{ 0x00, 0x60, 0x60, 0x00, 0x00 }, // .
+	{ 0x20, 0x10, 0x08, 0x04, 0x02 }, // /
+	{ 0x3e, 0x51, 0x49, 0x45, 0x3e }, // 0
+	{ 0x00, 0x42, 0x7f, 0x40, 0x00 }, // 1
+	{ 0x42, 0x61, 0x51, 0x49, 0x46 }, // 2
+	{ 0x21, 0x41, 0x45, 0x4b, 0x31 }, // 3
+	{ 0x18, 0x14, 0x12, 0x7f, 0x10 }, // 4
+	{ 0x27, 0x45, 0x45, 0x45, 0x39 }, // 5
+	{ 0x3c, 0x4a, 0x49, 0x49, 0x30 }, // 6
+	{ 0x01, 0x71, 0x09, 0x05, 0x03 }, // 7
+	{ 0x36, 0x49, 0x49, 0x49, 0x36 }, // 8
+	{ 0x06, 0x49, 0x49, 0x29, 0x1e }, // 9
+	{ 0x00, 0x36, 0x36, 0x00, 0x00 }, // :
+	{ 0x00, 0x56, 0x36, 0x00, 0x00 }, // ;
+	{ 0x08, 0x14, 0x22, 0x41, 0x00 }, // <
+	{ 0x14, 0x14, 0x14, 0x14, 0x14 }, // =
+	{ 0x00, 0x41, 0x22, 0x14, 0x08 }, // >
+	{ 0x02, 0x01, 0x51, 0x09, 0x06 }, // ?
+	{ 0x32, 0x49, 0x79, 0x41, 0x3e }, // @
+	{ 0x7e, 0x11, 0x11, 0x11, 0x7e }, // A
+	{ 0x7f, 0x49, 0x49, 0x49, 0x36 }, // B
+	{ 0x3e, 0x41, 0x41, 0x41, 0x22 }, // C
+	{ 0x7f, 0x41, 0x41, 0x22, 0x1c }, // D
+	{ 0x7f, 0x49, 0x49, 0x49, 0x41 }, // E
+	{ 0x7f, 0x09, 0x09, 0x09, 0x01 }, // F
+	{ 0x3e, 0x41, 0x49, 0x49, 0x7a }, // G
+	{ 0x7f, 0x08, 0x08, 0x08, 0x7f }, // H
+	{ 0x00, 0x41, 0x7f, 0x41, 0x00 }, // I
+	{ 0x20, 0x40, 0x41, 0x3f, 0x01 }, // J
+	{ 0x7f, 0x08, 0x14, 0x22, 0x41 }, // K
+	{ 0x7f, 0x40, 0x40, 0x40, 0x40 }, // L
+	{ 0x7f, 0x02, 0x0c, 0x02, 0x7f }, // M
+	{ 0x7f, 0x04, 0x08, 0x10, 0x7f }, // N
+	{ 0x3e, 0x41, 0x41, 0x41, 0x3e }, // O
+	{ 0x7f, 0x09, 0x09, 0x09, 0x06 }, // P
+	{ 0x3e, 0x41, 0x51, 0x21, 0x5e }, // Q
+	{ 0x7f, 0x09, 0x19, 0x29, 0x46 }, // R
+	{ 0x46, 0x49, 0x49, 0x49, 0x31 }, // S
+	{ 0x01, 0x01, 0x7f, 0x01, 0x01 }, // T
+	{ 0x3f, 0x40, 0x40, 0x40, 0x3f }, // U
+	{ 0x1f, 0x20, 0x40, 0x20, 0x1f }, // V
+	{ 0x3f, 0x40, 0x38, 0x40, 0x3f }, // W
+	{ 0x63, 0x14, 0x08, 0x14, 0x63 }, // X
+	{ 0x07, 0x08, 0x70, 0x08, 0x07 }, // Y
+	{ 0x61, 0x51, 0x49, 0x45, 0x43 }, // Z
+	{ 0x00, 0x7f, 0x41, 0x41, 0x00 }, // [
+	{ 0x02, 0x04, 0x08, 0x10, 0x20 }, // backslash
+	{ 0x00, 0x41, 0x41, 0x7f, 0x00 }, // ]
+	{ 0x04, 0x02, 0x01, 0x02, 0x04 }, // ^
+	{ 0x40, 0x40, 0x40, 0x40, 0x40 }, // _
+	{ 0x00, 0x01, 0x02, 0x04, 0x00 }, // `
+	{ 0x20, 0x54, 0x54, 0x54, 0x78 }, // a
+	{ 0x7f, 0x48, 0x44, 0x44, 0x38 }, // b
+	{ 0x38, 0x44, 0x44, 0x44, 0x20 }, // c
+	{ 0x38, 0x44, 0x44, 0x48, 0x7f }, // d
+	{ 0x38, 0x54, 0x54, 0x54, 0x18 }, // e
+	{ 0x08, 0x7e, 0x09, 0x01, 0x02 }, // f
+	{ 0x0c, 0x52, 0x52, 0x52, 0x3e }, // g
+	{ 0x7f, 0x08, 0x04, 0x04, 0x78 }, // h
+	{ 0x00, 0x44, 0x7d, 0x40, 0x00 }, // i
+	{ 0x20, 0x40, 0x44, 0x3d, 0x00 }, // j
+	{ 0x7f, 0x10, 0x28, 0x44, 0x00 }, // k
+	{ 0x00, 0x41, 0x7f, 0x40, 0x00 }, // l
+	{ 0x7c, 0x04, 0x18, 0x04, 0x78 }, // m
+	{ 0x7c, 0x08, 0x04, 0x04, 0x78 }, // n
+	{ 0x38, 0x44, 0x44, 0x44, 0x38 }, // o
+	{ 0x7c, 0x14, 0x14, 0x14, 0x08 }, // p
+	{ 0x08, 0x14, 0x14, 0x18, 0x7c }, // q
+	{ 0x7c, 0x08, 0x04, 0x04, 0x08 }, // r
+	{ 0x48, 0x54, 0x54, 0x54, 0x20 }, // s
+	{ 0x04, 0x3f, 0x44, 0x40, 0x20 }, // t
+	{ 0x3c, 0x40, 0x40, 0x20, 0x7c }, // u
+	{ 0x1c, 0x20, 0x40, 0x20, 0x1c }, // v
+	{ 0x3c, 0x40, 0x30, 0x40, 0x3c }, // w
+	{ 0x44, 0x28, 0x10, 0x28, 0x44 }, // x
+	{ 0x0c, 0x50, 0x50, 0x50, 0x3c }, // y
+	{ 0x44, 0x64, 0x54, 0x4c, 0x44 }, // z
+	{ 0x00, 0x08, 0x36, 0x41, 0x00 }, // {
+	{ 0x00, 0x00, 0x7f, 0x00, 0x00 }, // |
+	{ 0x00, 0x41, 0x36, 0x08, 0x00 }, // }
+	{ 0x08, 0x04, 0x08, 0x10, 0x08 }, // ~
+};
+
+ofxHvcP2Annotator::ofxHvcP2Annotator() {
+	data = NULL;
+	width = height = 0;
+	channels = 1;
+	sourceWidth = 1600;
+	sourceHeight = 1200;
+	textScale = 1;
+}
+
+void ofxHvcP2Annotator::begin(ofPixels &pixels) {
+	begin(pixels.getData(), pixels.getWidth(), pixels.getHeight(), pixels.getNumChannels());
+}
+
+void ofxHvcP2Annotator::begin(unsigned char *_data, int _width, int _height, int _channels) {
+	data = _data;
+	width = _width;
+	height = _height;
+	channels = ofClamp(_channels, 1, 4);
+}
+
+void ofxHvcP2Annotator::setSourceSize(int _width, int _height) {
+	sourceWidth = MAX(_width, 1);
+	sourceHeight = MAX(_height, 1);
+}
+
+void ofxHvcP2Annotator::setTextScale(int scale) {
+	textScale = MAX(scale, 1);
+}
+
+void ofxHvcP2Annotator::fillRect(int x, int y, int w, int h, const ofColor &color) {
+	unsigned char pixel[4];
+	makePixel(color, pixel);
+	fillRectPixel(x, y, w, h, pixel);
+}
+
+void ofxHvcP2Annotator::drawRect(int x, int y, int w, int h, const ofColor &color, int thickness) {
+	unsigned char pixel[4];
+	makePixel(color, pixel);
+	int t = MAX(MIN(thickness, MIN(w, h) / 2), 1);
+	fillRectPixel(x, y, w, t, pixel);
+	fillRectPixel(x, y + h - t, w, t, pixel);
+	fillRectPixel(x, y + t, t, h - 2 * t, pixel);
+	fillRectPixel(x + w - t, y + t, t, h - 2 * t, pixel);
+}
+
+void ofxHvcP2Annotator::drawText(int x, int y, const string &text, const ofColor &color, bool background) {
+	unsigned char pixel[4];
+	makePixel(color, pixel);
+	int s = textScale;
+
+	if (background) {
+		int columns = 0, lines = 1, column = 0;
+		for (char c : text) {
+			if (c == '\n') {
+				++lines;
+				column = 0;
+			}
+			else {
+				++column;
+				columns = MAX(columns, column);
+			}
+		}
+		fillRect(x - s, y - s, columns * glyphWidth * s + s, lines * glyphHeight * s + s, ofColor(0));
+	}
+
+	int penX = x, penY = y;
+	for (char c : text) {
+		if (c == '\n') {
+			penX = x;
+			penY += glyphHeight * s;
+			continue;
+		}
+		if (c >= 0x20 && c <= 0x7e && penX < width && penY < height && penX + glyphWidth * s > 0 && penY + glyphHeight * s > 0) {
+			const unsigned char *glyph = font5x7[c - 0x20];
+			// lit columns of a row are merged into one span
+			for (int row = 0; row < 7; ++row) {
+				int col = 0;
+				while (col < 5) {
+					if (!(glyph[col] & (1 << row))) {
+						++col;
+						continue;
+					}
+					int start = col;
+					while (col < 5 && (glyph[col] & (1 << row))) ++col;
+					fillRectPixel(penX + start * s, penY + row * s, (col - start) * s, s, pixel);
+				}
+			}
+		}
+		penX += glyphWidth * s;
+	}
+}
+
+void ofxHvcP2Annotator::drawDetection(int x, int y, int size, const ofColor &color, const string &label) {
+	float sx = (float)width / sourceWidth;
+	float sy = (float)height / sourceHeight;
+	int w = MAX(size * sx, 2.0f);
+	int h = MAX(size * sy, 2.0f);
+	int left = x * sx - w / 2;
+	int top = y * sy - h / 2;
+	drawRect(left, top, w, h, color, MAX(width / 320, 1));
+	if (!label.empty()) {
+		drawText(left, top + h + 2 * textScale, label, color);
+	}
+}
+
+void ofxHvcP2Annotator::draw(const ofxHvcP2::Faces &faces, const ofxHvcP2::Bodies &bodies, const ofxHvcP2::Hands &hands) {
+	for (auto &b : bodies) {
+		drawDetection(b.position.x, b.position.y, b.size, ofColor(0, 60, 255), "id:" + ofToString(b.trackingId));
+	}
+	for (auto &h : hands) {
+		drawDetection(h.position.x, h.position.y, h.size, ofColor(255, 210, 0), "id:" + ofToString(h.trackingId));
+	}
+	for (auto &f : faces) {
+		string label = "id:" + ofToString(f.trackingId);
+		if (f.ageStbState != ofxHvcP2::None) label += " " + ofToString(f.age);
+		if (f.gender != ofxHvcP2::UnknownGender && f.genderStbState != ofxHvcP2::None) label += f.gender == ofxHvcP2::Male ? " M" : " F";
+		drawDetection(f.position.x, f.position.y, f.size, ofColor(0, 255, 0), label);
+	}
+}
+
+void ofxHvcP2Annotator::makePixel(const ofColor &color, unsigned char *out) const {
+	if (channels < 3) {
+		// luma of the color for grayscale
+		out[0] = (color.r * 77 + color.g * 150 + color.b * 29) >> 8;
+		out[1] = 255;
+	}
+	else {
+		out[0] = color.r;
+		out[1] = color.g;
+		out[2] = color.b;
+		out[3] = 255;
+	}
+}
+
+void ofxHvcP2Annotator::fillSpan(unsigned char *row, int x0, int x1, const unsigned char *pixel) const {
+	int n = x1 - x0;
+	if (channels == 1) {
+		memset(row + x0, pixel[0], n);
+		return;
+	}
+	// one pixel, then copy the filled part doubling the length
+	unsigned char *p = row + x0 * channels;
+	size_t total = n * channels;
+	memcpy(p, pixel, channels);
+	size_t filled = channels;
+	while (filled < total) {
+		size_t count = MIN(filled, total - filled);
+		memcpy(p + filled, p, count);
+		filled += count;
+	}
+}
+
+void ofxHvcP2Annotator::fillRectPixel(int x, int y, int w, int h, const unsigned char *pixel) {
+	if (data == NULL) return;
+	int x0 = MAX(x, 0), x1 = MIN(x + w, width);
+	int y0 = MAX(y, 0), y1 = MIN(y + h, height);
+	if (x0 >= x1 || y0 >= y1) return;
+
+	int stride = width * channels;
+	for (int row = y0; row < y1; ++row) {
+		fillSpan(data + row * stride, x0, x1, pixel);
+	}
+}
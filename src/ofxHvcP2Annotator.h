@@ -0,0 +1,45 @@
+#pragma once
+#include "ofxHvcP2.h"
+
+// Draw detection rects, tracking IDs and labels into an image on CPU, without GL.
+// Works with the captured grayscale image (getImage().getPixels()) and with RGB / RGBA pixels.
+// Everything is clipped horizontal spans, filled with memset (gray) or doubling memcpy (color).
+// Text uses a built-in 5x7 bitmap font (ASCII).
+class ofxHvcP2Annotator {
+public:
+	ofxHvcP2Annotator();
+
+	// font cell including spacing, multiplied by the text scale
+	static const int glyphWidth = 6;
+	static const int glyphHeight = 8;
+
+	// target of the drawing. pixels have to live until the drawing is finished
+	void begin(ofPixels &pixels);
+	void begin(unsigned char *data, int width, int height, int channels);
+
+	// size of the detection coordinates, 1600x1200 of HVC by default
+	void setSourceSize(int width, int height);
+	// integer scale of the font
+	void setTextScale(int scale);
+
+	// image coordinates
+	void fillRect(int x, int y, int w, int h, const ofColor &color);
+	void drawRect(int x, int y, int w, int h, const ofColor &color, int thickness = 1);
+	// '\n' starts a new line. background is black
+	void drawText(int x, int y, const string &text, const ofColor &color, bool background = true);
+
+	// detection coordinates, position is the center. label is drawn under the rect
+	void drawDetection(int x, int y, int size, const ofColor &color, const string &label);
+	// same colors as the example (face green, body blue, hand yellow) with tracking IDs
+	void draw(const ofxHvcP2::Faces &faces, const ofxHvcP2::Bodies &bodies, const ofxHvcP2::Hands &hands);
+
+private:
+	void makePixel(const ofColor &color, unsigned char *out) const;
+	void fillSpan(unsigned char *row, int x0, int x1, const unsigned char *pixel) const;
+	void fillRectPixel(int x, int y, int w, int h, const unsigned char *pixel);
+
+	unsigned char *data;
+	int width, height, channels;
+	int sourceWidth, sourceHeight;
+	int textScale;
+};
@@ -0,0 +1,205 @@
+#include "ofxHvcP2Attention.h"
+
+static const uint64_t minuteMillis = 60000;
+
+ofxHvcP2Attention::ofxHvcP2Attention() {
+	directionYaw = 20;
+	directionPitch = 15;
+	gazeLR = 15;
+	gazeUD = 15;
+	hysteresis = 5;
+	useDirection = true;
+	useGaze = true;
+	lostTime = 1000;
+	numLooking = 0;
+	setBucketCapacity(1440);
+}
+
+void ofxHvcP2Attention::setDirectionCone(float yaw, float pitch) {
+	directionYaw = MAX(yaw, 0);
+	directionPitch = MAX(pitch, 0);
+}
+
+void ofxHvcP2Attention::setGazeCone(float lr, float ud) {
+	gazeLR = MAX(lr, 0);
+	gazeUD = MAX(ud, 0);
+}
+
+void ofxHvcP2Attention::setHysteresis(float degrees) {
+	hysteresis = MAX(degrees, 0);
+}
+
+void ofxHvcP2Attention::setUseDirection(bool enable) {
+	useDirection = enable;
+}
+
+void ofxHvcP2Attention::setUseGaze(bool enable) {
+	useGaze = enable;
+}
+
+void ofxHvcP2Attention::setLostTime(uint64_t millis) {
+	lostTime = millis;
+}
+
+void ofxHvcP2Attention::setBucketCapacity(int minutes) {
+	buckets.assign(MAX(minutes, 1), Bucket());
+	head = 0;
+	count = 0;
+	currentMinute = 0;
+	started = false;
+	currentDwell = currentAttention = 0;
+	currentPeople = currentViewers = 0;
+}
+
+void ofxHvcP2Attention::update(const ofxHvcP2::Faces &faces, uint64_t frameTime) {
+	uint64_t minute = frameTime / minuteMillis;
+	if (!started) {
+		currentMinute = minute;
+		started = true;
+	}
+	else if (minute > currentMinute) {
+		advanceMinute(minute);
+	}
+
+	for (auto &f : faces) {
+		if (f.trackingId < 0) continue;
+		Track *track = findTrack(f.trackingId, frameTime);
+		if (track == NULL) continue;
+		Visit &v = track->visit;
+
+		// the time from the last frame belongs to the last state
+		uint64_t dt = MIN(frameTime - v.lastTime, lostTime);
+		v.dwell += dt;
+		currentDwell += dt;
+		if (track->looking) {
+			v.attention += dt;
+			currentAttention += dt;
+		}
+		v.lastTime = frameTime;
+		v.identity = f.identity;
+
+		bool filtered = f.filtered.frames > 0;
+		float yaw = filtered ? f.filtered.direction.z : f.direction.z;
+		float pitch = filtered ? f.filtered.direction.x : f.direction.x;
+		bool hasGaze = filtered ? f.filtered.hasGaze : f.hasGaze;
+		float lr = filtered ? f.filtered.gaze.x : f.gaze.x;
+		float ud = filtered ? f.filtered.gaze.y : f.gaze.y;
+		bool looking = inCone(yaw, pitch, hasGaze, lr, ud, track->looking ? hysteresis : 0);
+		if (looking && !track->looking) ++v.looks;
+		track->looking = looking;
+
+		// minute + 1, because 0 is not counted yet
+		if (track->countedMinute != minute + 1) {
+			track->countedMinute = minute + 1;
+			++currentPeople;
+		}
+		if (looking && track->viewedMinute != minute + 1) {
+			track->viewedMinute = minute + 1;
+			++currentViewers;
+		}
+	}
+
+	lostVisits.clear();
+	numLooking = 0;
+	for (auto &t : tracks) {
+		if (!t.used) continue;
+		if (t.visit.lastTime + lostTime < frameTime) {
+			lostVisits.push_back(t.visit);
+			t.used = false;
+		}
+		else if (t.looking && t.visit.lastTime == frameTime) {
+			++numLooking;
+		}
+	}
+
+	for (auto &v : lostVisits) {
+		ofNotifyEvent(visitEvent, v, this);
+	}
+}
+
+void ofxHvcP2Attention::clear() {
+	for (auto &t : tracks) t.used = false;
+	numLooking = 0;
+	setBucketCapacity(buckets.size());
+}
+
+bool ofxHvcP2Attention::isLooking(int trackingId) const {
+	const Track *track = findTrack(trackingId);
+	return track != NULL && track->looking;
+}
+
+bool ofxHvcP2Attention::getVisit(int trackingId, Visit &out) const {
+	const Track *track = findTrack(trackingId);
+	if (track == NULL) return false;
+	out = track->visit;
+	return true;
+}
+
+void ofxHvcP2Attention::getBuckets(vector<Bucket> &out, uint64_t &firstMinute) const {
+	out.clear();
+	firstMinute = currentMinute - count;
+	if (!started) return;
+
+	int capacity = buckets.size();
+	for (int i = 0; i < count; ++i) {
+		out.push_back(buckets[(head - count + i + capacity) % capacity]);
+	}
+	out.push_back(getCurrentBucket());
+}
+
+ofxHvcP2Attention::Track *ofxHvcP2Attention::findTrack(int trackingId, uint64_t frameTime) {
+	Track *freeTrack = NULL;
+	for (auto &t : tracks) {
+		if (t.used && t.visit.trackingId == trackingId) return &t;
+		if (!t.used && freeTrack == NULL) freeTrack = &t;
+	}
+	if (freeTrack != NULL) {
+		*freeTrack = Track();
+		freeTrack->used = true;
+		freeTrack->visit.trackingId = trackingId;
+		// the first frame adds no time
+		freeTrack->visit.firstTime = frameTime;
+		freeTrack->visit.lastTime = frameTime;
+	}
+	return freeTrack;
+}
+
+const ofxHvcP2Attention::Track *ofxHvcP2Attention::findTrack(int trackingId) const {
+	for (auto &t : tracks) {
+		if (t.used && t.visit.trackingId == trackingId) return &t;
+	}
+	return NULL;
+}
+
+bool ofxHvcP2Attention::inCone(float yaw, float pitch, bool hasGaze, float lr, float ud, float margin) const {
+	if (useDirection && (fabsf(yaw) > directionYaw + margin || fabsf(pitch) > directionPitch + margin)) return false;
+	if (useGaze && hasGaze && (fabsf(lr) > gazeLR + margin || fabsf(ud) > gazeUD + margin)) return false;
+	return true;
+}
+
+void ofxHvcP2Attention::advanceMinute(uint64_t minute) {
+	pushBucket(getCurrentBucket());
+	// minutes without frames are empty
+	uint64_t skipped = MIN(minute - currentMinute - 1, (uint64_t)buckets.size());
+	for (uint64_t i = 0; i < skipped; ++i) pushBucket(Bucket());
+
+	currentMinute = minute;
+	currentDwell = currentAttention = 0;
+	currentPeople = currentViewers = 0;
+}
+
+void ofxHvcP2Attention::pushBucket(const Bucket &bucket) {
+	int capacity = buckets.size();
+	buckets[head] = bucket;
+	head = (head + 1) % capacity;
+	count = MIN(count + 1, capacity);
+}
+
+ofxHvcP2Attention::Bucket ofxHvcP2Attention::getCurrentBucket() const {
+	Bucket b;
+	b.dwell = MIN(currentDwell / 100, 65535u);
+	b.attention = MIN(currentAttention / 100, 65535u);
+	b.people = MIN(currentPeople, 255);
+	b.viewers = MIN(currentViewers, 255);
+	return b;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "ofxHvcP2.h"
+
+// Dwell and attention time of the audience of a display.
+// Each face track is looking while face direction and gaze are in the cones,
+// and stops looking when they leave the cones widened by the hysteresis.
+// Times of all tracks are totaled into per minute buckets, a day (1440 buckets) is about 8KB.
+// Filtered direction and gaze are used if setActiveFaceFilter is enabled.
+class ofxHvcP2Attention {
+public:
+	ofxHvcP2Attention();
+
+	static const int maxTracks = 35;
+
+	// 6 bytes per minute
+	struct Bucket {
+		uint16_t dwell = 0;     // total time of faces (1/10 sec)
+		uint16_t attention = 0; // total looking time (1/10 sec)
+		uint8_t people = 0;     // tracks in the minute
+		uint8_t viewers = 0;    // tracks which looked in the minute
+	};
+
+	// notified when a track is lost
+	struct Visit {
+		int trackingId = -1;
+		int identity = -1;
+		uint64_t firstTime = 0, lastTime = 0; // elapsed millis
+		uint64_t dwell = 0;                   // millis
+		uint64_t attention = 0;               // millis
+		int looks = 0;                        // times the track started looking
+	};
+
+	// half angles of the cones (degrees) and the margin to stop looking
+	void setDirectionCone(float yaw, float pitch);
+	void setGazeCone(float lr, float ud);
+	void setHysteresis(float degrees);
+	// use face direction and/or gaze (they have to be active in ofxHvcP2).
+	// faces without a gaze estimate are judged by the direction only
+	void setUseDirection(bool enable);
+	void setUseGaze(bool enable);
+	// time to keep a face which is not detected (millis), and the longest time added at once
+	void setLostTime(uint64_t millis);
+	// number of minute buckets to keep (1440 is a day)
+	void setBucketCapacity(int minutes);
+
+	// frameTime is elapsed millis when the frame was received
+	void update(const ofxHvcP2::Faces &faces, uint64_t frameTime);
+	void clear();
+
+	bool isLooking(int trackingId) const;
+	bool getVisit(int trackingId, Visit &out) const;
+	int getNumLooking() const { return numLooking; }
+
+	// oldest first, out[i] is the minute firstMinute + i (minutes from the start of the app)
+	// the last bucket is the current minute
+	void getBuckets(vector<Bucket> &out, uint64_t &firstMinute) const;
+
+	ofEvent<Visit> visitEvent;
+
+private:
+	struct Track {
+		bool used = false;
+		bool looking = false;
+		uint64_t countedMinute = 0;
+		uint64_t viewedMinute = 0;
+		Visit visit;
+	};
+
+	Track *findTrack(int trackingId, uint64_t frameTime);
+	const Track *findTrack(int trackingId) const;
+	bool inCone(float yaw, float pitch, bool hasGaze, float lr, float ud, float margin) const;
+	void advanceMinute(uint64_t minute);
+	void pushBucket(const Bucket &bucket);
+	Bucket getCurrentBucket() const;
+
+	float directionYaw, directionPitch;
+	float gazeLR, gazeUD;
+	float hysteresis;
+	bool useDirection, useGaze;
+	uint64_t lostTime;
+
+	Track tracks[maxTracks];
+	int numLooking;
+
+	// ring of finished minutes and the current minute in millis
+	vector<Bucket> buckets;
+	int head, count;
+	uint64_t currentMinute;
+	bool started;
+	uint32_t currentDwell, currentAttention;
+	int currentPeople, currentViewers;
+	vector<Visit> lostVisits;
+};
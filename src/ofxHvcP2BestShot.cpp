@@ -0,0 +1,151 @@
+#include "ofxHvcP2BestShot.h"
+
+ofxHvcP2BestShot::ofxHvcP2BestShot() {
+	setWeights(0.25f, 0.35f, 0.15f, 0.25f);
+	referenceSize = 300;
+	lostFrameCount = 1;
+	frameTime = 0;
+	lostShots.reserve(maxSlots);
+}
+
+void ofxHvcP2BestShot::setWeights(float confidence, float frontal, float size, float sharpness) {
+	float sum = confidence + frontal + size + sharpness;
+	if (sum <= 0) return;
+	confidenceWeight = confidence / sum;
+	frontalWeight = frontal / sum;
+	sizeWeight = size / sum;
+	sharpnessWeight = sharpness / sum;
+}
+
+void ofxHvcP2BestShot::setReferenceSize(int size) {
+	referenceSize = MAX(size, 1);
+}
+
+void ofxHvcP2BestShot::setLostFrameCount(int count) {
+	lostFrameCount = MAX(count, 1);
+}
+
+void ofxHvcP2BestShot::beginFrame(uint64_t time) {
+	frameTime = time;
+	lostShots.clear();
+	for (auto &s : slots) s.seen = false;
+}
+
+void ofxHvcP2BestShot::addFace(int trackingId, int confidence, bool hasDirection, int yaw, int pitch, int size,
+	const unsigned char *tile, int width, int height) {
+	if (trackingId < 0 || tile == NULL) return;
+
+	Slot *slot = NULL;
+	Slot *freeSlot = NULL;
+	for (auto &s : slots) {
+		if (s.used && s.shot.trackingId == trackingId) {
+			slot = &s;
+			break;
+		}
+		if (!s.used && freeSlot == NULL) freeSlot = &s;
+	}
+
+	// new track
+	if (slot == NULL) {
+		if (freeSlot == NULL) return;
+		slot = freeSlot;
+		slot->used = true;
+		slot->shot.trackingId = trackingId;
+		slot->shot.score = -1;
+		slot->shot.firstTime = frameTime;
+	}
+	slot->seen = true;
+	slot->missed = 0;
+
+	float sharpness = getSharpness(tile, width, height);
+	float score = getScore(confidence, hasDirection, yaw, pitch, size, sharpness);
+	if (score <= slot->shot.score) return;
+
+	auto &shot = slot->shot;
+	shot.score = score;
+	shot.confidence = confidence;
+	shot.yaw = yaw;
+	shot.pitch = pitch;
+	shot.size = size;
+	shot.sharpness = sharpness;
+	shot.time = frameTime;
+	shot.pixels.setFromPixels(tile, width, height, OF_IMAGE_GRAYSCALE);
+}
+
+void ofxHvcP2BestShot::endFrame() {
+	for (auto &s : slots) {
+		if (!s.used || s.seen) continue;
+		if (++s.missed >= lostFrameCount) {
+			lose(s);
+		}
+	}
+}
+
+void ofxHvcP2BestShot::flush() {
+	lostShots.clear();
+	for (auto &s : slots) {
+		if (s.used) lose(s);
+	}
+}
+
+void ofxHvcP2BestShot::clear() {
+	lostShots.clear();
+	for (auto &s : slots) {
+		s.used = false;
+		s.shot.trackingId = -1;
+	}
+}
+
+bool ofxHvcP2BestShot::getCurrentShot(int trackingId, Shot &out) const {
+	for (auto &s : slots) {
+		if (s.used && s.shot.trackingId == trackingId) {
+			out = s.shot;
+			return true;
+		}
+	}
+	return false;
+}
+
+float ofxHvcP2BestShot::getScore(int confidence, bool hasDirection, int yaw, int pitch, int size, float sharpness) const {
+	float confidenceScore = ofClamp(confidence / 1000.0f, 0, 1);
+	float frontalScore = 1;
+	if (hasDirection) {
+		// 0 at 60 degree from front
+		frontalScore = ofClamp(1.0f - sqrtf((float)(yaw * yaw + pitch * pitch)) / 60.0f, 0, 1);
+	}
+	float sizeScore = ofClamp((float)size / referenceSize, 0, 1);
+
+	return confidenceWeight * confidenceScore
+		+ frontalWeight * frontalScore
+		+ sizeWeight * sizeScore
+		+ sharpnessWeight * sharpness;
+}
+
+float ofxHvcP2BestShot::getSharpness(const unsigned char *tile, int width, int height) {
+	if (width < 3 || height < 3) return 0;
+
+	// 4-neighbour laplacian on inner pixels
+	uint64_t sum = 0;
+	for (int y = 1; y < height - 1; ++y) {
+		const unsigned char *up = tile + (y - 1) * width;
+		const unsigned char *row = up + width;
+		const unsigned char *down = row + width;
+		int rowSum = 0;
+		for (int x = 1; x < width - 1; ++x) {
+			int l = 4 * row[x] - row[x - 1] - row[x + 1] - up[x] - down[x];
+			rowSum += l < 0 ? -l : l;
+		}
+		sum += rowSum;
+	}
+	float mean = (float)sum / ((width - 2) * (height - 2));
+	return mean / (mean + 8.0f);
+}
+
+void ofxHvcP2BestShot::lose(Slot &slot) {
+	if (slot.shot.score >= 0) {
+		lostShots.push_back(slot.shot);
+	}
+	slot.used = false;
+	slot.missed = 0;
+	slot.shot.trackingId = -1;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "ofMain.h"
+
+// Keep the best face thumbnail of each tracking ID.
+// Number of slots is fixed, so memory does not grow while someone stays in view.
+// When a track is lost, its best shot is moved to the lost list.
+class ofxHvcP2BestShot {
+public:
+	ofxHvcP2BestShot();
+
+	struct Shot {
+		int trackingId = -1;
+		float score = 0;
+		int confidence = 0;
+		int yaw = 0, pitch = 0;
+		int size = 0;
+		float sharpness = 0;
+		uint64_t time = 0;     // elapsed millis when the shot was taken
+		uint64_t firstTime = 0; // elapsed millis when the track appeared
+		ofPixels pixels;
+	};
+
+	static const int maxSlots = 35;
+
+	// score weights (normalized when scoring)
+	void setWeights(float confidence, float frontal, float size, float sharpness);
+	// face size (HVC coordinate) that gets full size score
+	void setReferenceSize(int size);
+	// frames without the tracking ID before it is treated as lost
+	void setLostFrameCount(int count);
+
+	void beginFrame(uint64_t time);
+	// tile is grayscale face crop. hasDirection is false if face direction is not active.
+	void addFace(int trackingId, int confidence, bool hasDirection, int yaw, int pitch, int size,
+		const unsigned char *tile, int width, int height);
+	void endFrame();
+
+	// move all tracks to the lost list (e.g. when detection is stopped)
+	void flush();
+	void clear();
+
+	// shots of the tracks lost in the last endFrame() or flush()
+	const vector<Shot> &getLostShots() const { return lostShots; }
+	bool getCurrentShot(int trackingId, Shot &out) const;
+
+	float getScore(int confidence, bool hasDirection, int yaw, int pitch, int size, float sharpness) const;
+	// mean absolute laplacian, normalized to 0-1
+	static float getSharpness(const unsigned char *tile, int width, int height);
+
+private:
+	struct Slot {
+		bool used = false;
+		bool seen = false;
+		int missed = 0;
+		Shot shot;
+	};
+	Slot slots[maxSlots];
+	vector<Shot> lostShots;
+
+	void lose(Slot &slot);
+
+	float confidenceWeight, frontalWeight, sizeWeight, sharpnessWeight;
+	int referenceSize;
+	int lostFrameCount;
+	uint64_t frameTime;
+};
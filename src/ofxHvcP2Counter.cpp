@@ -0,0 +1,198 @@
+#include "ofxHvcP2Counter.h"
+
+ofxHvcP2Counter::ofxHvcP2Counter(int _width, int _height) {
+	width = MAX(_width, 1);
+	height = MAX(_height, 1);
+	gridWidth = (width + cellSize - 1) / cellSize;
+	gridHeight = (height + cellSize - 1) / cellSize;
+	grid.assign(gridWidth * gridHeight, 0);
+	numZones = 0;
+	numLines = 0;
+	lostFrameCount = 1;
+	resetCounters();
+}
+
+int ofxHvcP2Counter::addZone(const vector<ofVec2f> &polygon) {
+	if (numZones >= maxZones || polygon.size() < 3) return -1;
+	int zone = numZones++;
+	uint32_t bit = 1u << zone;
+
+	// even-odd rule at the center of each cell, scanline by scanline
+	int n = polygon.size();
+	vector<float> crossings;
+	for (int gy = 0; gy < gridHeight; ++gy) {
+		float y = (gy + 0.5f) * cellSize;
+		crossings.clear();
+		for (int i = 0; i < n; ++i) {
+			const ofVec2f &a = polygon[i];
+			const ofVec2f &b = polygon[(i + 1) % n];
+			if ((a.y <= y) == (b.y <= y)) continue;
+			crossings.push_back(a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y));
+		}
+		std::sort(crossings.begin(), crossings.end());
+		for (int i = 0; i + 1 < (int)crossings.size(); i += 2) {
+			int gx0 = MAX((int)ceilf(crossings[i] / cellSize - 0.5f), 0);
+			int gx1 = MIN((int)floorf(crossings[i + 1] / cellSize - 0.5f), gridWidth - 1);
+			for (int gx = gx0; gx <= gx1; ++gx) {
+				grid[gy * gridWidth + gx] |= bit;
+			}
+		}
+	}
+	return zone;
+}
+
+int ofxHvcP2Counter::addLine(const ofVec2f &from, const ofVec2f &to) {
+	if (numLines >= maxLines) return -1;
+	lines[numLines].from = from;
+	lines[numLines].to = to;
+	return numLines++;
+}
+
+void ofxHvcP2Counter::clearZones() {
+	std::fill(grid.begin(), grid.end(), 0);
+	numZones = 0;
+	numLines = 0;
+	for (auto &t : tracks) t.used = false;
+	resetCounters();
+}
+
+void ofxHvcP2Counter::setLostFrameCount(int count) {
+	lostFrameCount = MAX(count, 1);
+}
+
+void ofxHvcP2Counter::beginFrame() {
+	for (auto &t : tracks) t.seen = false;
+}
+
+void ofxHvcP2Counter::addTrack(int trackingId, int x, int y) {
+	if (trackingId < 0) return;
+
+	Track *track = NULL;
+	Track *freeTrack = NULL;
+	for (auto &t : tracks) {
+		if (t.used && t.trackingId == trackingId) {
+			track = &t;
+			break;
+		}
+		if (!t.used && freeTrack == NULL) freeTrack = &t;
+	}
+
+	uint32_t zones = getZoneMask(x, y);
+	if (track == NULL) {
+		if (freeTrack == NULL) return;
+		track = freeTrack;
+		*track = Track();
+		track->used = true;
+		track->trackingId = trackingId;
+		changeZones(0, zones);
+	}
+	else {
+		changeZones(track->zones, zones);
+		crossLines(track->x, track->y, x, y);
+	}
+	track->seen = true;
+	track->missed = 0;
+	track->x = x;
+	track->y = y;
+	track->zones = zones;
+}
+
+void ofxHvcP2Counter::endFrame() {
+	for (auto &t : tracks) {
+		if (!t.used || t.seen) continue;
+		if (++t.missed >= lostFrameCount) {
+			changeZones(t.zones, 0);
+			t.used = false;
+		}
+	}
+}
+
+void ofxHvcP2Counter::resetCounters() {
+	for (auto &c : zoneCounters) {
+		c.entries.store(0);
+		c.exits.store(0);
+		c.occupancy.store(0);
+	}
+	for (auto &c : lineCounters) {
+		c.forward.store(0);
+		c.backward.store(0);
+	}
+	// tracks inside zones are counted again
+	for (auto &t : tracks) {
+		if (t.used) changeZones(0, t.zones);
+	}
+}
+
+uint32_t ofxHvcP2Counter::getZoneMask(int x, int y) const {
+	if (x < 0 || y < 0 || x >= width || y >= height) return 0;
+	return grid[(y / cellSize) * gridWidth + x / cellSize];
+}
+
+int ofxHvcP2Counter::getOccupancy(int zone) const {
+	if (zone < 0 || zone >= maxZones) return 0;
+	return zoneCounters[zone].occupancy.load(std::memory_order_relaxed);
+}
+
+int ofxHvcP2Counter::getEntries(int zone) const {
+	if (zone < 0 || zone >= maxZones) return 0;
+	return zoneCounters[zone].entries.load(std::memory_order_relaxed);
+}
+
+int ofxHvcP2Counter::getExits(int zone) const {
+	if (zone < 0 || zone >= maxZones) return 0;
+	return zoneCounters[zone].exits.load(std::memory_order_relaxed);
+}
+
+int ofxHvcP2Counter::getForward(int line) const {
+	if (line < 0 || line >= maxLines) return 0;
+	return lineCounters[line].forward.load(std::memory_order_relaxed);
+}
+
+int ofxHvcP2Counter::getBackward(int line) const {
+	if (line < 0 || line >= maxLines) return 0;
+	return lineCounters[line].backward.load(std::memory_order_relaxed);
+}
+
+void ofxHvcP2Counter::changeZones(uint32_t before, uint32_t after) {
+	uint32_t changed = before ^ after;
+	while (changed) {
+		int zone = 0;
+		while (!(changed & (1u << zone))) ++zone;
+		changed &= ~(1u << zone);
+
+		auto &c = zoneCounters[zone];
+		if (after & (1u << zone)) {
+			c.entries.fetch_add(1, std::memory_order_relaxed);
+			c.occupancy.fetch_add(1, std::memory_order_relaxed);
+		}
+		else {
+			c.exits.fetch_add(1, std::memory_order_relaxed);
+			c.occupancy.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+void ofxHvcP2Counter::crossLines(int x0, int y0, int x1, int y1) {
+	if (x0 == x1 && y0 == y1) return;
+	for (int i = 0; i < numLines; ++i) {
+		const ofVec2f &a = lines[i].from;
+		const ofVec2f &b = lines[i].to;
+
+		// side of the line before and after the move (y is down, positive is right, on the line is left)
+		float ex = b.x - a.x, ey = b.y - a.y;
+		bool right0 = ex * (y0 - a.y) - ey * (x0 - a.x) > 0;
+		bool right1 = ex * (y1 - a.y) - ey * (x1 - a.x) > 0;
+		if (right0 == right1) continue;
+
+		// both ends of the line on each side of the move
+
+		float mx = x1 - x0, my = y1 - y0;
+		float sideA = mx * (a.y - y0) - my * (a.x - x0);
+		float sideB = mx * (b.y - y0) - my * (b.x - x0);
+		if ((sideA < 0) == (sideB < 0)) continue;
+
+		auto &c = lineCounters[i];
+		if (right1) c.forward.fetch_add(1, std::memory_order_relaxed);
+		else c.backward.fetch_add(1, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "ofMain.h"
+#include <atomic>
+
+// Count people entering and leaving zones, and crossing directional lines.
+// Zones are polygons rasterized once into a grid of zone bits, so point-in-zone is one read.
+// Counters are atomic and can be read from any thread while update runs.
+// Use one counter per kind of track (faces or bodies), tracking IDs are not shared.
+class ofxHvcP2Counter {
+public:
+	ofxHvcP2Counter(int width = 1600, int height = 1200);
+
+	static const int maxZones = 32;
+	static const int maxLines = 16;
+	static const int maxTracks = 70;
+	static const int cellSize = 8;
+
+	// setup, not thread safe. coordinates are HVC coordinates. return index, -1 if full
+	int addZone(const vector<ofVec2f> &polygon);
+	// forward is crossing from the left side to the right side of from -> to (y down)
+	int addLine(const ofVec2f &from, const ofVec2f &to);
+	void clearZones();
+	int getNumZones() const { return numZones; }
+	int getNumLines() const { return numLines; }
+
+	// frames without the tracking ID before it exits from its zones
+	void setLostFrameCount(int count);
+
+	void beginFrame();
+	void addTrack(int trackingId, int x, int y);
+	void endFrame();
+	void resetCounters();
+
+	// bit i is zone i
+	uint32_t getZoneMask(int x, int y) const;
+
+	// lock free
+	int getOccupancy(int zone) const;
+	int getEntries(int zone) const;
+	int getExits(int zone) const;
+	int getForward(int line) const;
+	int getBackward(int line) const;
+
+private:
+	struct Line {
+		ofVec2f from, to;
+	};
+	struct ZoneCounter {
+		std::atomic<int> entries;
+		std::atomic<int> exits;
+		std::atomic<int> occupancy;
+	};
+	struct LineCounter {
+		std::atomic<int> forward;
+		std::atomic<int> backward;
+	};
+	struct Track {
+		bool used = false;
+		bool seen = false;
+		int trackingId = -1;
+		int missed = 0;
+		int x = 0, y = 0;
+		uint32_t zones = 0;
+	};
+
+	void changeZones(uint32_t before, uint32_t after);
+	void crossLines(int x0, int y0, int x1, int y1);
+
+	int width, height;
+	int gridWidth, gridHeight;
+	vector<uint32_t> grid;
+	int numZones;
+	Line lines[maxLines];
+	int numLines;
+
+	ZoneCounter zoneCounters[maxZones];
+	LineCounter lineCounters[maxLines];
+
+	Track tracks[maxTracks];
+	int lostFrameCount;
+};
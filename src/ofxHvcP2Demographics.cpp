@@ -0,0 +1,156 @@
+#include "ofxHvcP2Demographics.h"
+
+static const uint64_t minuteMillis = 60000;
+
+int ofxHvcP2Demographics::Snapshot::getCount(int ageGroup) const {
+	if (ageGroup < 0 || ageGroup >= numAgeGroups) return 0;
+	return count[ageGroup][0] + count[ageGroup][1];
+}
+
+int ofxHvcP2Demographics::Snapshot::getCount(ofxHvcP2::Gender gender) const {
+	if (gender == ofxHvcP2::UnknownGender) return 0;
+	int g = gender == ofxHvcP2::Male ? 0 : 1;
+	int sum = 0;
+	for (int a = 0; a < numAgeGroups; ++a) sum += count[a][g];
+	return sum;
+}
+
+ofxHvcP2Demographics::ofxHvcP2Demographics() {
+	lostTime = 5000;
+	minutes.resize(dayMinutes);
+	clear();
+}
+
+void ofxHvcP2Demographics::setLostTime(uint64_t millis) {
+	lostTime = millis;
+}
+
+int ofxHvcP2Demographics::getAgeGroup(int age) {
+	return ofClamp(age / 10, 0, numAgeGroups - 1);
+}
+
+string ofxHvcP2Demographics::getAgeGroupName(int ageGroup) {
+	if (ageGroup < 0 || ageGroup >= numAgeGroups) return "";
+	if (ageGroup == numAgeGroups - 1) return ofToString(ageGroup * 10) + "-";
+	return ofToString(ageGroup * 10) + "-" + ofToString(ageGroup * 10 + 9);
+}
+
+void ofxHvcP2Demographics::update(const ofxHvcP2::Faces &faces, uint64_t frameTime) {
+	uint64_t minute = frameTime / minuteMillis;
+	if (!started) {
+		currentMinute = minute;
+		started = true;
+	}
+	else if (minute > currentMinute) {
+		advanceMinute(minute);
+	}
+
+	for (auto &f : faces) {
+		if (f.trackingId < 0) continue;
+		int key = f.identity >= 0 ? f.identity : f.trackingId;
+		if (isCounted(key)) {
+			setCounted(key, frameTime);
+			continue;
+		}
+		if (f.ageStbState != ofxHvcP2::Complete || f.genderStbState != ofxHvcP2::Complete) continue;
+		if (f.gender == ofxHvcP2::UnknownGender) continue;
+
+		setCounted(key, frameTime);
+		int a = getAgeGroup(f.age);
+		int g = f.gender == ofxHvcP2::Male ? 0 : 1;
+		// expiring windows only count what the minute slot can hold, so they return to zero
+		auto &counts = minutes[currentMinute % dayMinutes];
+		bool full = counts.count[a][g] == 65535;
+		if (!full) ++counts.count[a][g];
+		for (int w = 0; w < 4; ++w) {
+			if (full && w != Total) continue;
+			++windows[w].count[a][g];
+			++windows[w].total;
+		}
+	}
+
+	for (auto &t : tracks) {
+		if (t.used && t.lastTime + lostTime < frameTime) t.used = false;
+	}
+}
+
+void ofxHvcP2Demographics::clear() {
+	for (auto &t : tracks) t.used = false;
+	for (auto &m : minutes) m = MinuteCounts();
+	for (auto &w : windows) w = Snapshot();
+	currentMinute = 0;
+	started = false;
+}
+
+ofxHvcP2Demographics::Snapshot ofxHvcP2Demographics::getSnapshot(Window window) const {
+	return windows[window];
+}
+
+string ofxHvcP2Demographics::getCsv() const {
+	static const char *windowNames[] = { "minute", "hour", "day", "total" };
+	string csv = "window,age,male,female\n";
+	for (int w = 0; w < 4; ++w) {
+		for (int a = 0; a < numAgeGroups; ++a) {
+			csv += string(windowNames[w]) + "," + getAgeGroupName(a) + ","
+				+ ofToString(windows[w].count[a][0]) + "," + ofToString(windows[w].count[a][1]) + "\n";
+		}
+	}
+	return csv;
+}
+
+bool ofxHvcP2Demographics::isCounted(int key) const {
+	for (auto &t : tracks) {
+		if (t.used && t.key == key) return true;
+	}
+	return false;
+}
+
+void ofxHvcP2Demographics::setCounted(int key, uint64_t frameTime) {
+	Track *freeTrack = NULL;
+	for (auto &t : tracks) {
+		if (t.used && t.key == key) {
+			t.lastTime = frameTime;
+			return;
+		}
+		if (!t.used && freeTrack == NULL) freeTrack = &t;
+	}
+	// when full, the face not detected for the longest time is forgotten
+	if (freeTrack == NULL) {
+		freeTrack = &tracks[0];
+		for (auto &t : tracks) {
+			if (t.lastTime < freeTrack->lastTime) freeTrack = &t;
+		}
+	}
+	freeTrack->used = true;
+	freeTrack->key = key;
+	freeTrack->lastTime = frameTime;
+}
+
+void ofxHvcP2Demographics::advanceMinute(uint64_t minute) {
+	// after a day, every minute has expired
+	if (minute - currentMinute >= dayMinutes) {
+		for (auto &m : minutes) m = MinuteCounts();
+		windows[Minute] = windows[Hour] = windows[Day] = Snapshot();
+		currentMinute = minute;
+		return;
+	}
+
+	while (currentMinute < minute) {
+		add(windows[Minute], minutes[currentMinute % dayMinutes], -1);
+		++currentMinute;
+		// minute 60 ago leaves the hour, and the ring slot of the day ago is reused
+		if (currentMinute >= 60) add(windows[Hour], minutes[(currentMinute - 60) % dayMinutes], -1);
+		auto &expired = minutes[currentMinute % dayMinutes];
+		add(windows[Day], expired, -1);
+		expired = MinuteCounts();
+	}
+}
+
+void ofxHvcP2Demographics::add(Snapshot &window, const MinuteCounts &counts, int sign) {
+	for (int a = 0; a < numAgeGroups; ++a) {
+		for (int g = 0; g < numGenders; ++g) {
+			window.count[a][g] += sign * counts.count[a][g];
+			window.total += sign * counts.count[a][g];
+		}
+	}
+}
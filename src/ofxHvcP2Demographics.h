@@ -0,0 +1,71 @@
+#pragma once
+#include "ofxHvcP2.h"
+
+// Audience statistics of age and gender.
+// Each tracking ID is counted once, when both age and gender become Complete in STB
+// (setActiveAge and setActiveGender are needed). Faces joined by re-identification
+// (Face::identity) are not counted again.
+// Counts are kept per minute for a day, and the minute, hour and day windows are
+// running totals, so counting and reading are O(1).
+class ofxHvcP2Demographics {
+public:
+	ofxHvcP2Demographics();
+
+	static const int maxTracks = 64;
+	static const int numAgeGroups = 7; // 0-9, 10-19, ... 60-
+	static const int numGenders = 2;   // male, female
+	static const int dayMinutes = 1440;
+
+	enum Window {
+		Minute, // current minute
+		Hour,   // current minute and the last 59 minutes
+		Day,    // current minute and the last 1439 minutes
+		Total   // since the start or clear()
+	};
+
+	struct Snapshot {
+		int count[numAgeGroups][numGenders] = {};
+		int total = 0;
+		int getCount(int ageGroup) const;                   // both genders
+		int getCount(ofxHvcP2::Gender gender) const;        // all ages
+	};
+
+	static int getAgeGroup(int age);
+	static string getAgeGroupName(int ageGroup);
+
+	// time to remember a counted face which is not detected (millis, default 5000).
+	// with re-identification, use at least the max gap (setReIdentificationMaxGap)
+	void setLostTime(uint64_t millis);
+
+	// frameTime is elapsed millis when the frame was received
+	void update(const ofxHvcP2::Faces &faces, uint64_t frameTime);
+	void clear();
+
+	Snapshot getSnapshot(Window window) const;
+	// rows of window, age group, male, female
+	string getCsv() const;
+
+private:
+	struct MinuteCounts {
+		uint16_t count[numAgeGroups][numGenders] = {};
+	};
+
+	bool isCounted(int key) const;
+	void setCounted(int key, uint64_t frameTime);
+	void advanceMinute(uint64_t minute);
+	void add(Snapshot &window, const MinuteCounts &counts, int sign);
+
+	// counted tracking IDs (or identities) while they are in view
+	struct Track {
+		bool used = false;
+		int key = -1;
+		uint64_t lastTime = 0;
+	};
+	Track tracks[maxTracks];
+	uint64_t lostTime;
+
+	vector<MinuteCounts> minutes; // ring indexed by minute % dayMinutes
+	uint64_t currentMinute;
+	bool started;
+	Snapshot windows[4];
+};
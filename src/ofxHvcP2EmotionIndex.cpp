@@ -0,0 +1,159 @@
+#include "ofxHvcP2EmotionIndex.h"
+
+// indices of Face::expressionScore
+static const int happinessIndex = 1;
+static const int angerIndex = 3;
+static const int sadnessIndex = 4;
+
+float ofxHvcP2EmotionIndex::Track::getShare(int expression) const {
+	if (expression < 0 || expression >= numExpressions) return 0;
+	uint32_t total = 0;
+	for (auto t : time) total += t;
+	return total > 0 ? time[expression] / (float)total : 0;
+}
+
+float ofxHvcP2EmotionIndex::Track::getValence() const {
+	return weight > 0 ? valence / (100.0f * weight) : 0;
+}
+
+ofxHvcP2EmotionIndex::ofxHvcP2EmotionIndex() {
+	lostTime = 1000;
+	setWindow(10);
+}
+
+void ofxHvcP2EmotionIndex::setWindow(int seconds) {
+	buckets.assign(MAX(seconds, 1), Bucket());
+	windowValence = windowHappiness = windowWeight = 0;
+	currentSecond = 0;
+	started = false;
+}
+
+void ofxHvcP2EmotionIndex::setLostTime(uint64_t millis) {
+	lostTime = millis;
+}
+
+void ofxHvcP2EmotionIndex::update(const ofxHvcP2::Faces &faces, uint64_t frameTime) {
+	uint64_t second = frameTime / 1000;
+	if (!started) {
+		currentSecond = second;
+		started = true;
+	}
+	else if (second > currentSecond) {
+		advanceSecond(second);
+	}
+	Bucket &bucket = buckets[currentSecond % buckets.size()];
+
+	for (auto &f : faces) {
+		if (f.trackingId < 0 || f.expression == ofxHvcP2::UnknownExpression) continue;
+		Slot *slot = findSlot(f.trackingId, frameTime);
+		if (slot == NULL) continue;
+		Track &t = slot->track;
+		t.identity = f.identity;
+
+		int top = f.filtered.frames > 0 && f.filtered.expression >= 0 ? f.filtered.expression : f.expression - 1;
+		top = ofClamp(top, 0, numExpressions - 1);
+		int valence = f.expressionScore[happinessIndex] - f.expressionScore[angerIndex] - f.expressionScore[sadnessIndex];
+		int happiness = f.expressionScore[happinessIndex];
+
+		// the first frame of a track counts as 100 millis
+		int dt = t.lastTime < frameTime ? MIN(frameTime - t.lastTime, lostTime) : 100;
+		t.lastTime = frameTime;
+		t.time[top] += dt;
+		t.valence += valence * dt;
+		t.weight += dt;
+
+		// extend the last run, or start a new one.
+		// millis are summed per run, so frames shorter than 1/10 sec are not rounded away.
+		// once a change is dropped at maxRuns, the last run is not extended across it
+		if (!t.truncated) {
+			if (!t.runs.empty() && t.runs.back().expression == top && (t.runTime + dt + 50) / 100 <= 65535) {
+				t.runTime += dt;
+				t.runs.back().duration = (t.runTime + 50) / 100;
+			}
+			else if ((int)t.runs.size() < maxRuns) {
+				Run r;
+				r.expression = top;
+				r.duration = (dt + 50) / 100;
+				t.runs.push_back(r);
+				t.runTime = dt;
+			}
+			else {
+				t.truncated = true;
+			}
+		}
+
+		bucket.valence += valence * dt;
+		bucket.happiness += happiness * dt;
+		bucket.weight += dt;
+		windowValence += valence * dt;
+		windowHappiness += happiness * dt;
+		windowWeight += dt;
+	}
+
+	lostTracks.clear();
+	for (auto &s : slots) {
+		if (s.used && s.track.lastTime + lostTime < frameTime) {
+			lostTracks.push_back(s.track);
+			s.used = false;
+		}
+	}
+	for (auto &t : lostTracks) {
+		ofNotifyEvent(trackEvent, t, this);
+	}
+}
+
+void ofxHvcP2EmotionIndex::clear() {
+	for (auto &s : slots) s.used = false;
+	setWindow(buckets.size());
+}
+
+float ofxHvcP2EmotionIndex::getValence() const {
+	return windowWeight > 0 ? windowValence / (100.0f * windowWeight) : 0;
+}
+
+float ofxHvcP2EmotionIndex::getHappiness() const {
+	return windowWeight > 0 ? windowHappiness / (100.0f * windowWeight) : 0;
+}
+
+float ofxHvcP2EmotionIndex::getFaceTime() const {
+	return windowWeight / 1000.0f;
+}
+
+bool ofxHvcP2EmotionIndex::getTrack(int trackingId, Track &out) const {
+	for (auto &s : slots) {
+		if (s.used && s.track.trackingId == trackingId) {
+			out = s.track;
+			return true;
+		}
+	}
+	return false;
+}
+
+ofxHvcP2EmotionIndex::Slot *ofxHvcP2EmotionIndex::findSlot(int trackingId, uint64_t frameTime) {
+	Slot *freeSlot = NULL;
+	for (auto &s : slots) {
+		if (s.used && s.track.trackingId == trackingId) return &s;
+		if (!s.used && freeSlot == NULL) freeSlot = &s;
+	}
+	if (freeSlot != NULL) {
+		freeSlot->used = true;
+		freeSlot->track = Track();
+		freeSlot->track.trackingId = trackingId;
+		freeSlot->track.firstTime = frameTime;
+		freeSlot->track.lastTime = frameTime;
+	}
+	return freeSlot;
+}
+
+void ofxHvcP2EmotionIndex::advanceSecond(uint64_t second) {
+	// seconds which leave the window are subtracted, at most once per bucket
+	uint64_t steps = MIN(second - currentSecond, (uint64_t)buckets.size());
+	for (uint64_t i = 1; i <= steps; ++i) {
+		Bucket &b = buckets[(currentSecond + i) % buckets.size()];
+		windowValence -= b.valence;
+		windowHappiness -= b.happiness;
+		windowWeight -= b.weight;
+		b = Bucket();
+	}
+	currentSecond = second;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "ofxHvcP2.h"
+
+// Expression statistics of each face track and the emotion of the whole audience.
+// Each track keeps the time of each top expression and the sequence of top expressions
+// as runs (expression and duration), so a long visit is a few bytes per change.
+// Valence (happiness - anger - sadness) and happiness of all faces are weighted by time
+// and summed in integer per second buckets, and the sliding window is a running total.
+// Filtered expression is used if setActiveFaceFilter is enabled (less runs by the hysteresis).
+class ofxHvcP2EmotionIndex {
+public:
+	ofxHvcP2EmotionIndex();
+
+	static const int maxTracks = 35;
+	static const int numExpressions = 5; // neutral, happiness, surprise, anger, sadness
+	static const int maxRuns = 1024;     // per track, then Track::truncated is set
+
+	// 4 bytes
+	struct Run {
+		uint8_t expression = 0;  // index of numExpressions
+		uint16_t duration = 0;   // 1/10 sec
+	};
+
+	struct Track {
+		int trackingId = -1;
+		int identity = -1;
+		uint64_t firstTime = 0, lastTime = 0; // elapsed millis
+		uint32_t time[numExpressions] = {};   // millis of each top expression
+		int64_t valence = 0;                  // sum of score x millis
+		uint32_t weight = 0;                  // millis of valence
+		vector<Run> runs;
+		uint32_t runTime = 0;                 // millis of the last run, its duration is rounded from this
+		bool truncated = false;               // runs reached maxRuns, the following frames are not recorded
+
+		// ratio of the time (0-1)
+		float getShare(int expression) const;
+		// -1 (negative) to 1 (positive)
+		float getValence() const;
+	};
+
+	// length of the sliding window (sec)
+	void setWindow(int seconds);
+	// time to keep a face which is not detected (millis), and the longest time added at once
+	void setLostTime(uint64_t millis);
+
+	// frameTime is elapsed millis when the frame was received
+	void update(const ofxHvcP2::Faces &faces, uint64_t frameTime);
+	void clear();
+
+	// audience in the sliding window. -1 to 1, 0 if nobody
+	float getValence() const;
+	// 0 to 1
+	float getHappiness() const;
+	// face time in the window (sec)
+	float getFaceTime() const;
+
+	bool getTrack(int trackingId, Track &out) const;
+	// notified when a track is lost
+	ofEvent<Track> trackEvent;
+
+private:
+	// score x millis, fixed point of the audience
+	struct Bucket {
+		int32_t valence = 0;
+		int32_t happiness = 0;
+		int32_t weight = 0;
+	};
+	struct Slot {
+		bool used = false;
+		Track track;
+	};
+
+	Slot *findSlot(int trackingId, uint64_t frameTime);
+	void advanceSecond(uint64_t second);
+
+	Slot slots[maxTracks];
+	uint64_t lostTime;
+
+	vector<Bucket> buckets; // ring indexed by second % window
+	uint64_t currentSecond;
+	bool started;
+	int64_t windowValence, windowHappiness, windowWeight;
+	vector<Track> lostTracks;
+};
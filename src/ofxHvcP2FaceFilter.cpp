@@ -0,0 +1,153 @@
+#include "ofxHvcP2FaceFilter.h"
+
+// cutoff of the velocity used by one euro filter (Hz)
+static const float velocityCutoff = 1.0f;
+
+static float smoothingFactor(float cutoff, float dt) {
+	float tau = 1.0f / (2 * PI * cutoff);
+	return 1.0f / (1.0f + tau / dt);
+}
+
+float ofxHvcP2FaceFilter::OneEuro::filter(float x, float dt, float minCutoff, float beta) {
+	float a = smoothingFactor(velocityCutoff, dt);
+	velocity += a * ((x - value) / dt - velocity);
+	float cutoff = minCutoff + beta * fabsf(velocity);
+	value += smoothingFactor(cutoff, dt) * (x - value);
+	return value;
+}
+
+ofxHvcP2FaceFilter::ofxHvcP2FaceFilter() {
+	minCutoff = 0.5f;
+	beta = 0.02f;
+	blinkAlpha = 0.5f;
+	expressionAlpha = 0.3f;
+	expressionMargin = 10;
+	lostFrameCount = 3;
+	frameTime = 0;
+}
+
+void ofxHvcP2FaceFilter::setAngleFilter(float _minCutoff, float _beta) {
+	minCutoff = MAX(_minCutoff, 0.01f);
+	beta = MAX(_beta, 0.0f);
+}
+
+void ofxHvcP2FaceFilter::setBlinkSmoothing(float alpha) {
+	blinkAlpha = ofClamp(alpha, 0.01f, 1.0f);
+}
+
+void ofxHvcP2FaceFilter::setExpressionSmoothing(float alpha) {
+	expressionAlpha = ofClamp(alpha, 0.01f, 1.0f);
+}
+
+void ofxHvcP2FaceFilter::setExpressionHysteresis(float margin) {
+	expressionMargin = MAX(margin, 0.0f);
+}
+
+void ofxHvcP2FaceFilter::setLostFrameCount(int count) {
+	lostFrameCount = MAX(count, 1);
+}
+
+void ofxHvcP2FaceFilter::beginFrame(uint64_t time) {
+	frameTime = time;
+	for (auto &s : slots) s.seen = false;
+}
+
+void ofxHvcP2FaceFilter::update(int trackingId, const Sample &in, Result &out) {
+	if (trackingId < 0) return;
+
+	Slot *slot = NULL;
+	Slot *freeSlot = NULL;
+	for (auto &s : slots) {
+		if (s.used && s.trackingId == trackingId) {
+			slot = &s;
+			break;
+		}
+		if (!s.used && freeSlot == NULL) freeSlot = &s;
+	}
+
+	// new track
+	if (slot == NULL) {
+		if (freeSlot == NULL) return;
+		slot = freeSlot;
+		*slot = Slot();
+		slot->used = true;
+		slot->trackingId = trackingId;
+		slot->time = frameTime;
+	}
+	slot->seen = true;
+	slot->missed = 0;
+
+	auto &r = slot->result;
+	float dt = MAX((frameTime - slot->time) / 1000.0f, 0.001f);
+	slot->time = frameTime;
+
+	// angles
+	if (in.hasDirection) {
+		float x[3] = { (float)in.pitch, (float)in.roll, (float)in.yaw };
+		for (int i = 0; i < 3; ++i) {
+			if (slot->angleFrames == 0) slot->angle[i].value = x[i];
+			else slot->angle[i].filter(x[i], dt, minCutoff, beta);
+		}
+		r.direction.set(slot->angle[0].value, slot->angle[1].value, slot->angle[2].value);
+		++slot->angleFrames;
+	}
+	if (in.hasGaze) {
+		float x[2] = { (float)in.gazeLR, (float)in.gazeUD };
+		for (int i = 0; i < 2; ++i) {
+			if (slot->gazeFrames == 0) slot->angle[3 + i].value = x[i];
+			else slot->angle[3 + i].filter(x[i], dt, minCutoff, beta);
+		}
+		r.gaze.set(slot->angle[3].value, slot->angle[4].value);
+		r.hasGaze = true;
+		++slot->gazeFrames;
+	}
+
+	// blink
+	if (in.hasBlink) {
+		if (slot->blinkFrames == 0) {
+			r.blinkL = in.blinkL;
+			r.blinkR = in.blinkR;
+		}
+		else {
+			r.blinkL += blinkAlpha * (in.blinkL - r.blinkL);
+			r.blinkR += blinkAlpha * (in.blinkR - r.blinkR);
+		}
+		r.hasBlink = true;
+		++slot->blinkFrames;
+	}
+
+	// expression, top changes only when another score is higher by the margin
+	if (in.hasExpression) {
+		int top = 0;
+		for (int i = 0; i < numExpressions; ++i) {
+			if (slot->expressionFrames == 0) r.expressionScore[i] = in.expressionScore[i];
+			else r.expressionScore[i] += expressionAlpha * (in.expressionScore[i] - r.expressionScore[i]);
+			if (r.expressionScore[i] > r.expressionScore[top]) top = i;
+		}
+		if (r.expression < 0 || r.expressionScore[top] > r.expressionScore[r.expression] + expressionMargin) {
+			r.expression = top;
+		}
+		++slot->expressionFrames;
+	}
+
+	// confidence mean and deviation
+	++r.frames;
+	float delta = in.confidence - slot->mean;
+	slot->mean += delta / r.frames;
+	slot->m2 += delta * (in.confidence - slot->mean);
+	r.confidenceMean = slot->mean;
+	r.confidenceDeviation = r.frames > 1 ? sqrtf(slot->m2 / (r.frames - 1)) : 0;
+
+	out = r;
+}
+
+void ofxHvcP2FaceFilter::endFrame() {
+	for (auto &s : slots) {
+		// keep the state through short dropouts of the tracking ID
+		if (s.used && !s.seen && ++s.missed >= lostFrameCount) s.used = false;
+	}
+}
+
+void ofxHvcP2FaceFilter::clear() {
+	for (auto &s : slots) s.used = false;
+}
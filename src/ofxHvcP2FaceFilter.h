@@ -0,0 +1,84 @@
+#pragma once
+#include "ofMain.h"
+
+// Temporal filters of face estimation per tracking ID.
+// Angles use one euro filter (smooth when still, follows quickly when moving),
+// blink and expression scores use EMA, and the top expression has hysteresis.
+// Each update is O(1) and slots are fixed.
+class ofxHvcP2FaceFilter {
+public:
+	ofxHvcP2FaceFilter();
+
+	static const int maxSlots = 35;
+	static const int numExpressions = 5; // neutral, happiness, surprise, anger, sadness
+
+	struct Sample {
+		int confidence = 0;
+		bool hasDirection = false;
+		int pitch = 0, roll = 0, yaw = 0;
+		bool hasGaze = false;
+		int gazeLR = 0, gazeUD = 0;
+		bool hasBlink = false;
+		int blinkL = 0, blinkR = 0;
+		bool hasExpression = false;
+		int expressionScore[numExpressions] = {};
+	};
+
+	struct Result {
+		ofVec3f direction; // pitch, roll, yaw
+		ofVec2f gaze;      // LR, UD
+		bool hasGaze = false;  // false until a gaze sample is given
+		float blinkL = 0, blinkR = 0;
+		bool hasBlink = false; // false until a blink sample is given
+		float expressionScore[numExpressions] = {};
+		int expression = -1; // index of expressionScore, -1 if unknown
+		float confidenceMean = 0;
+		float confidenceDeviation = 0;
+		int frames = 0;
+	};
+
+	// one euro filter parameters for angles (cutoff in Hz, beta per degree/sec)
+	void setAngleFilter(float minCutoff, float beta);
+	// EMA weight of the new value (0-1)
+	void setBlinkSmoothing(float alpha);
+	void setExpressionSmoothing(float alpha);
+	// score margin to change the top expression
+	void setExpressionHysteresis(float margin);
+	// frames without the tracking ID before the filter state is removed
+	void setLostFrameCount(int count);
+
+	// time is elapsed millis
+	void beginFrame(uint64_t time);
+	// tracks which are not updated for lostFrameCount frames are removed at endFrame()
+	void update(int trackingId, const Sample &in, Result &out);
+	void endFrame();
+	void clear();
+
+private:
+	struct OneEuro {
+		float value = 0, velocity = 0;
+		float filter(float x, float dt, float minCutoff, float beta);
+	};
+	struct Slot {
+		bool used = false;
+		bool seen = false;
+		int missed = 0;
+		int trackingId = -1;
+		uint64_t time = 0;
+		OneEuro angle[5]; // pitch, roll, yaw, gazeLR, gazeUD
+		int angleFrames = 0;
+		int gazeFrames = 0;
+		int blinkFrames = 0;
+		int expressionFrames = 0;
+		float mean = 0, m2 = 0; // Welford
+		Result result;
+	};
+	Slot slots[maxSlots];
+
+	float minCutoff, beta;
+	float blinkAlpha;
+	float expressionAlpha;
+	float expressionMargin;
+	int lostFrameCount;
+	uint64_t frameTime;
+};
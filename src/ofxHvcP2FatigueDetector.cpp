@@ -0,0 +1,182 @@
+#include "ofxHvcP2FatigueDetector.h"
+
+// learning rate of the open level
+static const float openLearning = 0.05f;
+// margin to close = deviationScale x deviation of the open level (at least minContrast)
+static const float deviationScale = 4.0f;
+// observed part of the window needed for Fatigue, and PERCLOS ratio to clear it
+static const float minObserved = 0.5f;
+static const float fatigueRelease = 0.8f;
+
+ofxHvcP2FatigueDetector::ofxHvcP2FatigueDetector() {
+	window = 60;
+	perclosThreshold = 0.15f;
+	longClosure = 1000;
+	minContrast = 200;
+	lostTime = 1000;
+}
+
+void ofxHvcP2FatigueDetector::setWindow(int seconds) {
+	window = ofClamp(seconds, 1, maxWindow);
+	clear();
+}
+
+void ofxHvcP2FatigueDetector::setPerclosThreshold(float ratio) {
+	perclosThreshold = ofClamp(ratio, 0, 1);
+}
+
+void ofxHvcP2FatigueDetector::setLongClosure(uint64_t millis) {
+	longClosure = millis;
+}
+
+void ofxHvcP2FatigueDetector::setMinContrast(int ratio) {
+	minContrast = MAX(ratio, 1);
+}
+
+void ofxHvcP2FatigueDetector::setLostTime(uint64_t millis) {
+	lostTime = millis;
+}
+
+void ofxHvcP2FatigueDetector::update(const ofxHvcP2::Faces &faces, uint64_t frameTime) {
+	events.clear();
+
+	for (auto &f : faces) {
+		// 0 is not estimated
+		if (f.trackingId < 0 || f.blinkL <= 0 || f.blinkR <= 0) continue;
+		int ratio = (f.blinkL + f.blinkR) / 2;
+		Slot *slot = findSlot(f.trackingId, ratio, frameTime);
+		if (slot == NULL) continue;
+		Slot &s = *slot;
+
+		// the time from the last frame belongs to the last state
+		uint64_t second = frameTime / 1000;
+		if (second > s.currentSecond) advanceSecond(s, second);
+		int dt = MIN(frameTime - s.lastTime, lostTime);
+		Second &current = s.seconds[s.currentSecond % window];
+		current.observed = MIN(current.observed + dt, 65535);
+		s.observedSum += dt;
+		if (s.closed) {
+			current.closed = MIN(current.closed + dt, 65535);
+			s.closedSum += dt;
+		}
+		s.lastTime = frameTime;
+
+		float margin = getMargin(s);
+		if (!s.closed && ratio > s.openMean + margin) {
+			s.closed = true;
+			s.closeStart = frameTime;
+			s.longNotified = false;
+		}
+		else if (s.closed && ratio < s.openMean + margin / 2) {
+			s.closed = false;
+			uint64_t duration = frameTime - s.closeStart;
+			if (duration < longClosure) {
+				if (current.blinks < 255) ++current.blinks;
+				++s.blinkSum;
+				addEvent(Blink, s, frameTime, duration);
+			}
+		}
+
+		// learn the open level only from open frames
+		if (!s.closed) {
+			s.openMean += openLearning * (ratio - s.openMean);
+			s.openDeviation += openLearning * (fabsf(ratio - s.openMean) - s.openDeviation);
+		}
+
+		if (s.closed && !s.longNotified && frameTime - s.closeStart >= longClosure) {
+			s.longNotified = true;
+			addEvent(LongClosure, s, frameTime, frameTime - s.closeStart);
+		}
+
+		float perclos = s.observedSum > 0 ? s.closedSum / (float)s.observedSum : 0;
+		bool enough = s.observedSum >= minObserved * window * 1000;
+		if (!s.fatigued && enough && perclos >= perclosThreshold) {
+			s.fatigued = true;
+			addEvent(Fatigue, s, frameTime, 0);
+		}
+		else if (s.fatigued && perclos < perclosThreshold * fatigueRelease) {
+			s.fatigued = false;
+		}
+	}
+
+	for (auto &s : slots) {
+		if (s.used && s.lastTime + lostTime < frameTime) s.used = false;
+	}
+
+	for (auto &e : events) {
+		ofNotifyEvent(fatigueEvent, e, this);
+	}
+}
+
+void ofxHvcP2FatigueDetector::clear() {
+	for (auto &s : slots) s.used = false;
+	events.clear();
+}
+
+bool ofxHvcP2FatigueDetector::getState(int trackingId, State &out) const {
+	for (auto &s : slots) {
+		if (s.used && s.trackingId == trackingId) {
+			makeState(s, out);
+			return true;
+		}
+	}
+	return false;
+}
+
+ofxHvcP2FatigueDetector::Slot *ofxHvcP2FatigueDetector::findSlot(int trackingId, int ratio, uint64_t frameTime) {
+	Slot *freeSlot = NULL;
+	for (auto &s : slots) {
+		if (s.used && s.trackingId == trackingId) return &s;
+		if (!s.used && freeSlot == NULL) freeSlot = &s;
+	}
+	if (freeSlot != NULL) {
+		// the first frame is assumed to be open
+		*freeSlot = Slot();
+		freeSlot->used = true;
+		freeSlot->trackingId = trackingId;
+		freeSlot->lastTime = frameTime;
+		freeSlot->currentSecond = frameTime / 1000;
+		freeSlot->openMean = ratio;
+		freeSlot->openDeviation = minContrast / deviationScale / 2;
+	}
+	return freeSlot;
+}
+
+void ofxHvcP2FatigueDetector::advanceSecond(Slot &slot, uint64_t second) {
+	// seconds which leave the window are subtracted, at most once per bucket
+	uint64_t steps = MIN(second - slot.currentSecond, (uint64_t)window);
+	for (uint64_t i = 1; i <= steps; ++i) {
+		Second &old = slot.seconds[(slot.currentSecond + i) % window];
+		slot.closedSum -= old.closed;
+		slot.observedSum -= old.observed;
+		slot.blinkSum -= old.blinks;
+		old = Second();
+	}
+	slot.currentSecond = second;
+}
+
+float ofxHvcP2FatigueDetector::getMargin(const Slot &slot) const {
+	return MIN(MAX(deviationScale * slot.openDeviation, (float)minContrast), 1000 - slot.openMean - 1);
+}
+
+void ofxHvcP2FatigueDetector::makeState(const Slot &slot, State &out) const {
+	out.closed = slot.closed;
+	out.fatigued = slot.fatigued;
+	out.perclos = slot.observedSum > 0 ? slot.closedSum / (float)slot.observedSum : 0;
+	out.blinkRate = slot.observedSum > 0 ? slot.blinkSum * 60000.0f / slot.observedSum : 0;
+	out.openLevel = slot.openMean;
+	out.threshold = slot.openMean + getMargin(slot);
+}
+
+void ofxHvcP2FatigueDetector::addEvent(Type type, const Slot &slot, uint64_t time, uint64_t duration) {
+	State state;
+	makeState(slot, state);
+	Event e;
+	e.type = type;
+	e.trackingId = slot.trackingId;
+	e.time = time;
+	e.duration = duration;
+	e.perclos = state.perclos;
+	e.blinkRate = state.blinkRate;
+	events.push_back(e);
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "ofxHvcP2.h"
+
+// Blink and eye closure (PERCLOS) of each face track from blink ratios (setActiveBlink).
+// Eyes are closed when the ratio rises above the open level of the track by an adaptive margin,
+// and open again below half of the margin. The open level and its deviation are learned per track.
+// Closed time, observed time and blinks are kept per second in a fixed ring for the window,
+// so memory per track is constant and every frame is O(1).
+// Short blinks can be missed at low frame rates, PERCLOS is less affected.
+class ofxHvcP2FatigueDetector {
+public:
+	ofxHvcP2FatigueDetector();
+
+	static const int maxTracks = 35;
+	static const int maxWindow = 120; // sec
+
+	enum Type {
+		Blink,       // eyes opened after a short closure
+		LongClosure, // eyes are closed for longClosure, notified while closed
+		Fatigue      // PERCLOS of the window is over the threshold
+	};
+
+	struct Event {
+		Type type;
+		int trackingId = -1;
+		uint64_t time = 0;     // elapsed millis of the frame
+		uint64_t duration = 0; // closure millis (Blink, LongClosure)
+		float perclos = 0;     // 0-1
+		float blinkRate = 0;   // blinks per minute
+	};
+
+	struct State {
+		bool closed = false;
+		bool fatigued = false;
+		float perclos = 0;
+		float blinkRate = 0;
+		float openLevel = 0; // learned blink ratio of open eyes
+		float threshold = 0; // ratio to close
+	};
+
+	// PERCLOS window (sec, up to maxWindow)
+	void setWindow(int seconds);
+	// ratio of closed time to raise Fatigue (0-1)
+	void setPerclosThreshold(float ratio);
+	// closure time to raise LongClosure (millis), longer closures are not blinks
+	void setLongClosure(uint64_t millis);
+	// smallest difference of blink ratio (1-1000) between open and closed
+	void setMinContrast(int ratio);
+	// time to keep a face which is not detected (millis)
+	void setLostTime(uint64_t millis);
+
+	// frameTime is elapsed millis when the frame was received
+	void update(const ofxHvcP2::Faces &faces, uint64_t frameTime);
+	void clear();
+
+	bool getState(int trackingId, State &out) const;
+
+	// events of the last update
+	const vector<Event> &getEvents() const { return events; }
+	ofEvent<Event> fatigueEvent;
+
+private:
+	struct Second {
+		uint16_t closed = 0;   // millis
+		uint16_t observed = 0; // millis
+		uint8_t blinks = 0;
+	};
+	struct Slot {
+		bool used = false;
+		int trackingId = -1;
+		uint64_t lastTime = 0;
+		bool closed = false;
+		uint64_t closeStart = 0;
+		bool longNotified = false;
+		bool fatigued = false;
+		float openMean = 0, openDeviation = 0;
+		Second seconds[maxWindow];
+		uint64_t currentSecond = 0;
+		int closedSum = 0, observedSum = 0, blinkSum = 0;
+	};
+
+	Slot *findSlot(int trackingId, int ratio, uint64_t frameTime);
+	void advanceSecond(Slot &slot, uint64_t second);
+	float getMargin(const Slot &slot) const;
+	void makeState(const Slot &slot, State &out) const;
+	void addEvent(Type type, const Slot &slot, uint64_t time, uint64_t duration);
+
+	Slot slots[maxTracks];
+	int window;
+	float perclosThreshold;
+	uint64_t longClosure;
+	int minContrast;
+	uint64_t lostTime;
+	vector<Event> events;
+};
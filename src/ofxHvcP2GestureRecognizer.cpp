@@ -0,0 +1,176 @@
+#include "ofxHvcP2GestureRecognizer.h"
+
+// windows (millis) and distances (ratio of hand size) of each gesture
+static const uint64_t waveWindow = 1500;
+static const float waveStep = 0.15f;
+static const float waveAmplitude = 0.4f;
+static const int waveReversals = 2;
+static const uint64_t swipeWindow = 800;
+static const float swipeDistance = 2.0f;
+static const uint64_t raiseWindow = 1000;
+static const float raiseDistance = 2.0f;
+static const float straightness = 0.6f; // max cross movement / main movement
+static const uint64_t holdTime = 1000;
+static const float holdRadius = 0.3f;
+
+ofxHvcP2GestureRecognizer::ofxHvcP2GestureRecognizer() {
+	cooldown = 500;
+	lostTime = 1000;
+	updateTime = 0;
+	gestures.reserve(maxHands);
+}
+
+string ofxHvcP2GestureRecognizer::getTypeName(Type type) {
+	switch (type) {
+	case Wave: return "Wave"; break;
+	case SwipeLeft: return "SwipeLeft"; break;
+	case SwipeRight: return "SwipeRight"; break;
+	case Raise: return "Raise"; break;
+	case Hold: return "Hold"; break;
+	default: return "";
+	}
+}
+
+void ofxHvcP2GestureRecognizer::setCooldown(uint64_t millis) {
+	cooldown = millis;
+}
+
+void ofxHvcP2GestureRecognizer::setLostTime(uint64_t millis) {
+	lostTime = millis;
+}
+
+void ofxHvcP2GestureRecognizer::update(const ofxHvcP2::Hands &hands, uint64_t frameTime) {
+	uint64_t startTime = ofGetElapsedTimeMicros();
+	gestures.clear();
+
+	for (auto &h : hands) {
+		if (h.trackingId < 0) continue;
+		Slot *slot = findSlot(h.trackingId);
+		if (slot == NULL) continue;
+
+		slot->bodyTrackingId = h.bodyTrackingId;
+		slot->lastTime = frameTime;
+		auto &s = slot->samples[slot->head];
+		s.time = frameTime;
+		s.x = h.position.x;
+		s.y = h.position.y;
+		s.size = MAX(h.size, 1);
+		slot->head = (slot->head + 1) % historySize;
+		slot->count = MIN(slot->count + 1, historySize);
+
+		Type type;
+		if (frameTime < slot->cooldownUntil || !recognize(*slot, type)) continue;
+
+		Gesture g;
+		g.type = type;
+		g.trackingId = slot->trackingId;
+		g.bodyTrackingId = slot->bodyTrackingId;
+		g.position = h.position;
+		g.frameTime = frameTime;
+		gestures.push_back(g);
+
+		// history is consumed by the gesture, hold continues until the hand moves
+		slot->cooldownUntil = frameTime + cooldown;
+		if (type != Hold) slot->count = 1;
+	}
+
+	for (auto &slot : slots) {
+		if (slot.used && slot.lastTime + lostTime < frameTime) slot.used = false;
+	}
+	updateTime = ofGetElapsedTimeMicros() - startTime;
+
+	for (auto &g : gestures) {
+		g.latency = (ofGetElapsedTimeMicros() - g.frameTime * 1000) / 1000.0f;
+		ofNotifyEvent(gestureEvent, g, this);
+	}
+}
+
+void ofxHvcP2GestureRecognizer::clear() {
+	for (auto &slot : slots) slot.used = false;
+	gestures.clear();
+}
+
+ofxHvcP2GestureRecognizer::Slot *ofxHvcP2GestureRecognizer::findSlot(int trackingId) {
+	Slot *freeSlot = NULL;
+	for (auto &slot : slots) {
+		if (slot.used && slot.trackingId == trackingId) return &slot;
+		if (!slot.used && freeSlot == NULL) freeSlot = &slot;
+	}
+	if (freeSlot != NULL) {
+		*freeSlot = Slot();
+		freeSlot->used = true;
+		freeSlot->trackingId = trackingId;
+	}
+	return freeSlot;
+}
+
+bool ofxHvcP2GestureRecognizer::recognize(Slot &slot, Type &type) {
+	if (slot.count < 2) return false;
+	const Sample &latest = sample(slot, 0);
+	float size = latest.size;
+
+	// hold : all samples in holdTime stay near the latest position
+	bool still = true;
+	bool longEnough = false;
+	for (int n = 1; n < slot.count && still; ++n) {
+		const Sample &s = sample(slot, n);
+		float dx = s.x - latest.x;
+		float dy = s.y - latest.y;
+		still = dx * dx + dy * dy < holdRadius * holdRadius * size * size;
+		if (latest.time - s.time >= holdTime) {
+			longEnough = true;
+			break;
+		}
+	}
+	if (!still) slot.holding = false;
+	if (still && longEnough && !slot.holding) {
+		slot.holding = true;
+		type = Hold;
+		return true;
+	}
+
+	// wave : horizontal direction changes several times
+	int reversals = 0;
+	int direction = 0;
+	float segment = 0;
+	float amplitude = 0;
+	float anchorX = latest.x;
+	for (int n = 1; n < slot.count; ++n) {
+		const Sample &s = sample(slot, n);
+		if (latest.time - s.time > waveWindow) break;
+		float dx = anchorX - s.x;
+		if (fabsf(dx) < waveStep * size) continue;
+
+		int d = dx > 0 ? 1 : -1;
+		if (direction != 0 && d != direction) {
+			amplitude = MAX(amplitude, segment);
+			segment = 0;
+			++reversals;
+		}
+		direction = d;
+		segment += fabsf(dx);
+		anchorX = s.x;
+	}
+	amplitude = MAX(amplitude, segment);
+	if (reversals >= waveReversals && amplitude >= waveAmplitude * size) {
+		type = Wave;
+		return true;
+	}
+
+	// swipe and raise : straight movement in the window
+	for (int n = slot.count - 1; n >= 1; --n) {
+		const Sample &s = sample(slot, n);
+		uint64_t elapsed = latest.time - s.time;
+		float dx = latest.x - s.x;
+		float dy = latest.y - s.y;
+		if (elapsed <= swipeWindow && fabsf(dx) >= swipeDistance * size && fabsf(dy) <= straightness * fabsf(dx) && reversals == 0) {
+			type = dx < 0 ? SwipeLeft : SwipeRight;
+			return true;
+		}
+		if (elapsed <= raiseWindow && -dy >= raiseDistance * size && fabsf(dx) <= straightness * -dy) {
+			type = Raise;
+			return true;
+		}
+	}
+	return false;
+}
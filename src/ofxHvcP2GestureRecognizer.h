@@ -0,0 +1,79 @@
+#pragma once
+#include "ofxHvcP2.h"
+
+// Recognize hand gestures incrementally from tracked hands (Hand::trackingId).
+// Each hand has a fixed ring buffer of recent positions, and each frame
+// checks wave, swipe, raise and hold in the window ending at the frame.
+// Distances are ratio of the hand size, so they do not depend on the distance from the camera.
+// Left and right are as seen from the camera.
+class ofxHvcP2GestureRecognizer {
+public:
+	ofxHvcP2GestureRecognizer();
+
+	static const int maxHands = 35;
+	static const int historySize = 16;
+
+	enum Type {
+		Wave,
+		SwipeLeft,
+		SwipeRight,
+		Raise,
+		Hold
+	};
+	static string getTypeName(Type type);
+
+	struct Gesture {
+		Type type;
+		int trackingId = -1;     // hand
+		int bodyTrackingId = -1; // linked body of the hand
+		ofxHvcP2::vec2i position;
+		uint64_t frameTime = 0; // elapsed millis of the frame which completed the gesture
+		float latency = 0;      // millis from frameTime to the notification
+	};
+
+	// time to wait after a gesture of the same hand (millis)
+	void setCooldown(uint64_t millis);
+	// time to keep a hand which is not detected (millis)
+	void setLostTime(uint64_t millis);
+
+	// frameTime is elapsed millis when the frame was received (e.g. when isFrameNew() becomes true)
+	void update(const ofxHvcP2::Hands &hands, uint64_t frameTime);
+	void clear();
+
+	// gestures of the last update
+	const vector<Gesture> &getGestures() const { return gestures; }
+	// processing time of the last update (micros)
+	uint64_t getUpdateTime() const { return updateTime; }
+
+	ofEvent<Gesture> gestureEvent;
+
+private:
+	struct Sample {
+		uint64_t time;
+		float x, y, size;
+	};
+	struct Slot {
+		bool used = false;
+		int trackingId = -1;
+		int bodyTrackingId = -1;
+		Sample samples[historySize];
+		int head = 0;
+		int count = 0;
+		uint64_t lastTime = 0;
+		uint64_t cooldownUntil = 0;
+		bool holding = false;
+	};
+
+	Slot *findSlot(int trackingId);
+	bool recognize(Slot &slot, Type &type);
+	// n = 0 is the latest
+	const Sample &sample(const Slot &slot, int n) const {
+		return slot.samples[(slot.head + historySize - 1 - n) % historySize];
+	}
+
+	Slot slots[maxHands];
+	vector<Gesture> gestures;
+	uint64_t cooldown;
+	uint64_t lostTime;
+	uint64_t updateTime;
+};
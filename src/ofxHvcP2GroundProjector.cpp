@@ -0,0 +1,150 @@
+#include "ofxHvcP2GroundProjector.h"
+
+// smoothing of the velocity (weight of the new value)
+static const float velocitySmoothing = 0.5f;
+
+ofxHvcP2GroundProjector::ofxHvcP2GroundProjector() {
+	mountHeight = 2.0f;
+	tilt = 20;
+	fov = 90; // B5T-007001-010 (wide angle)
+	cameraAngle = 0;
+	faceSize = 0.16f;
+	bodySize = 0.45f;
+	frameTime = 0;
+	updateTables();
+}
+
+void ofxHvcP2GroundProjector::setMountHeight(float meters) {
+	mountHeight = meters;
+}
+
+void ofxHvcP2GroundProjector::setTilt(float degrees) {
+	tilt = ofClamp(degrees, -89, 89);
+	updateTables();
+}
+
+void ofxHvcP2GroundProjector::setFov(float degrees) {
+	fov = ofClamp(degrees, 1, 170);
+	updateTables();
+}
+
+void ofxHvcP2GroundProjector::setCameraAngle(int angleNo) {
+	cameraAngle = angleNo & 3;
+	updateTables();
+}
+
+void ofxHvcP2GroundProjector::setFaceSize(float meters) {
+	faceSize = MAX(meters, 0.01f);
+}
+
+void ofxHvcP2GroundProjector::setBodySize(float meters) {
+	bodySize = MAX(meters, 0.01f);
+}
+
+void ofxHvcP2GroundProjector::updateTables() {
+	// 90 and 270 degrees swap the image axes, focal length stays the same
+	bool rotated = cameraAngle == 1 || cameraAngle == 3;
+	width = rotated ? sensorHeight : sensorWidth;
+	height = rotated ? sensorWidth : sensorHeight;
+	focal = (sensorWidth / 2.0f) / tanf(fov * DEG_TO_RAD / 2);
+
+	float c = cosf(tilt * DEG_TO_RAD);
+	float s = sinf(tilt * DEG_TO_RAD);
+	rayX.resize(width);
+	for (int u = 0; u < width; ++u) {
+		rayX[u] = (u + 0.5f - width / 2.0f) / focal;
+	}
+	rayY.resize(height);
+	rayZ.resize(height);
+	for (int v = 0; v < height; ++v) {
+		float y = (v + 0.5f - height / 2.0f) / focal;
+		rayY[v] = y * c + s; // down
+		rayZ[v] = c - y * s; // forward
+	}
+	depthPerMeter.resize(sensorWidth + 1);
+	depthPerMeter[0] = 0;
+	for (int size = 1; size <= sensorWidth; ++size) {
+		depthPerMeter[size] = focal / size;
+	}
+}
+
+ofxHvcP2GroundProjector::Position ofxHvcP2GroundProjector::project(int x, int y, int size, Prior prior) const {
+	Position p;
+	if (size <= 0) return p;
+
+	int u = ofClamp(x, 0, width - 1);
+	int v = ofClamp(y, 0, height - 1);
+	float realSize = prior == FacePrior ? faceSize : bodySize;
+	float depth = depthPerMeter[MIN(size, sensorWidth)] * realSize;
+
+	p.x = rayX[u] * depth;
+	p.z = rayZ[v] * depth;
+	p.height = mountHeight - rayY[v] * depth;
+	p.distance = sqrtf(p.x * p.x + p.z * p.z);
+	p.valid = p.z > 0;
+	return p;
+}
+
+bool ofxHvcP2GroundProjector::projectGaze(const Position &face, float yaw, float pitch, const ofRectangle &display, ofVec2f &out) const {
+	// looking away from the display plane
+	if (!face.valid || fabsf(yaw) >= 80 || fabsf(pitch) >= 80 || display.width <= 0 || display.height <= 0) return false;
+
+	float x = face.x + face.z * tanf(yaw * DEG_TO_RAD);
+	float y = (mountHeight - face.height) - face.z * tanf(pitch * DEG_TO_RAD);
+	out.x = (x - display.x) / display.width;
+	out.y = (y - display.y) / display.height;
+	return true;
+}
+
+void ofxHvcP2GroundProjector::beginFrame(uint64_t time) {
+	frameTime = time;
+	for (auto &t : tracks) t.seen = false;
+}
+
+ofxHvcP2GroundProjector::Position ofxHvcP2GroundProjector::update(int trackingId, int x, int y, int size, Prior prior) {
+	Position p = project(x, y, size, prior);
+	if (trackingId < 0 || !p.valid) return p;
+
+	Track *track = NULL;
+	Track *freeTrack = NULL;
+	for (auto &t : tracks) {
+		if (t.used && t.trackingId == trackingId && t.prior == prior) {
+			track = &t;
+			break;
+		}
+		if (!t.used && freeTrack == NULL) freeTrack = &t;
+	}
+
+	if (track == NULL) {
+		if (freeTrack == NULL) return p;
+		track = freeTrack;
+		*track = Track();
+		track->used = true;
+		track->trackingId = trackingId;
+		track->prior = prior;
+	}
+	else if (frameTime > track->time) {
+		float dt = (frameTime - track->time) / 1000.0f;
+		ofVec2f current((p.x - track->x) / dt, (p.z - track->z) / dt);
+		track->velocity.x += velocitySmoothing * (current.x - track->velocity.x);
+		track->velocity.y += velocitySmoothing * (current.y - track->velocity.y);
+	}
+	track->seen = true;
+	track->time = frameTime;
+	track->x = p.x;
+	track->z = p.z;
+
+	p.velocity = track->velocity;
+	p.speed = sqrtf(p.velocity.x * p.velocity.x + p.velocity.y * p.velocity.y);
+	return p;
+}
+
+void ofxHvcP2GroundProjector::endFrame() {
+	for (auto &t : tracks) {
+		if (t.used && !t.seen) t.used = false;
+	}
+}
+
+void ofxHvcP2GroundProjector::clear() {
+	for (auto &t : tracks) t.used = false;
+}
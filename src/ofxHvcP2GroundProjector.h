@@ -0,0 +1,86 @@
+#pragma once
+#include "ofMain.h"
+
+// Project detections to the floor with a pinhole camera model.
+// Depth comes from the detection size and a real size prior (face or body width),
+// and the ray through the detection center is rotated by the mounting tilt.
+// Rays of each image column and row and the depth of each size are in lookup tables,
+// so a projection is a few table reads and multiplications.
+// Floor coordinates are meters, x to the right and z forward from the point under the camera.
+class ofxHvcP2GroundProjector {
+public:
+	ofxHvcP2GroundProjector();
+
+	static const int maxTracks = 35;
+
+	enum Prior {
+		FacePrior,
+		BodyPrior
+	};
+
+	struct Position {
+		bool valid = false;
+		float x = 0, z = 0;  // floor position (m)
+		float distance = 0;  // horizontal distance from the camera (m)
+		float height = 0;    // height of the detection center from the floor (m)
+		float speed = 0;     // walking speed (m/sec), update() only
+		ofVec2f velocity;    // x, z (m/sec), update() only
+	};
+
+	// camera height from the floor (m)
+	void setMountHeight(float meters);
+	// downward tilt of the camera (degrees)
+	void setTilt(float degrees);
+	// horizontal field of view of the lens at camera angle 0 (degrees)
+	void setFov(float degrees);
+	// same value as HVC_SetCameraAngle (0: 0, 1: 90, 2: 180, 3: 270 degrees)
+	void setCameraAngle(int angleNo);
+	// real width of the detection (m)
+	void setFaceSize(float meters);
+	void setBodySize(float meters);
+
+	// x, y and size are HVC coordinates
+	Position project(int x, int y, int size, Prior prior) const;
+
+	// point on the display where a projected face looks at (0-1 of the display, can be outside).
+	// the display is on the vertical plane of the camera, display rect is meters from the camera
+	// (x to the right, y down). yaw and pitch are face direction + gaze (degrees),
+	// positive yaw is to the right of the image and positive pitch is up.
+	bool projectGaze(const Position &face, float yaw, float pitch, const ofRectangle &display, ofVec2f &out) const;
+
+	// project and calculate speed of the tracking ID. time is elapsed millis
+	void beginFrame(uint64_t time);
+	Position update(int trackingId, int x, int y, int size, Prior prior);
+	void endFrame();
+	void clear();
+
+private:
+	void updateTables();
+
+	float mountHeight;
+	float tilt;
+	float fov;
+	int cameraAngle;
+	float faceSize, bodySize;
+
+	// HVC coordinates of camera angle 0 are 1600x1200
+	static const int sensorWidth = 1600;
+	static const int sensorHeight = 1200;
+	int width, height;
+	float focal;
+	vector<float> rayX;          // per column
+	vector<float> rayY, rayZ;    // per row, rotated by tilt
+	vector<float> depthPerMeter; // per size, depth of 1m wide object
+
+	struct Track {
+		bool used = false;
+		bool seen = false;
+		Prior prior = FacePrior;
+		int trackingId = -1;
+		uint64_t time = 0;
+		float x = 0, z = 0;
+		ofVec2f velocity;
+	};
+	Track tracks[maxTracks * 2];
+	uint64_t frameTime;
+};
@@ -0,0 +1,156 @@
+#include "ofxHvcP2HandTracker.h"
+
+ofxHvcP2HandTracker::ofxHvcP2HandTracker() {
+	gate = 1.5f;
+	retryCount = 3;
+	bodyLinkDistance = 1.5f;
+	numDetections = 0;
+	numBodies = 0;
+	nextId = 0;
+}
+
+void ofxHvcP2HandTracker::setGate(float ratio) {
+	gate = MAX(ratio, 0.1f);
+}
+
+void ofxHvcP2HandTracker::setRetryCount(int count) {
+	retryCount = MAX(count, 0);
+}
+
+void ofxHvcP2HandTracker::setBodyLinkDistance(float ratio) {
+	bodyLinkDistance = MAX(ratio, 0.0f);
+}
+
+void ofxHvcP2HandTracker::beginFrame() {
+	numDetections = 0;
+	numBodies = 0;
+}
+
+void ofxHvcP2HandTracker::addHand(int x, int y, int size) {
+	if (numDetections >= maxHands) return;
+	auto &d = detections[numDetections++];
+	d.x = x;
+	d.y = y;
+	d.size = size;
+	d.trackingId = -1;
+	d.bodyTrackingId = -1;
+}
+
+void ofxHvcP2HandTracker::addBody(int trackingId, int x, int y, int size) {
+	if (numBodies >= maxBodies || trackingId < 0) return;
+	auto &b = bodies[numBodies++];
+	b.trackingId = trackingId;
+	b.x = x;
+	b.y = y;
+	b.size = size;
+}
+
+void ofxHvcP2HandTracker::endFrame() {
+	associate();
+	linkBodies();
+}
+
+void ofxHvcP2HandTracker::clear() {
+	for (auto &t : tracks) t.used = false;
+	numDetections = 0;
+	numBodies = 0;
+}
+
+int ofxHvcP2HandTracker::getTrackingId(int index) const {
+	if (index < 0 || index >= numDetections) return -1;
+	return detections[index].trackingId;
+}
+
+int ofxHvcP2HandTracker::getBodyTrackingId(int index) const {
+	if (index < 0 || index >= numDetections) return -1;
+	return detections[index].bodyTrackingId;
+}
+
+void ofxHvcP2HandTracker::associate() {
+	// candidate pairs inside the gate, compared with the predicted position
+	int numPairs = 0;
+	for (int t = 0; t < maxTracks; ++t) {
+		auto &track = tracks[t];
+		track.matched = false;
+		if (!track.used) continue;
+
+		float steps = track.missed + 1;
+		float px = track.x + track.vx * steps;
+		float py = track.y + track.vy * steps;
+		for (int d = 0; d < numDetections; ++d) {
+			auto &det = detections[d];
+			float dx = det.x - px;
+			float dy = det.y - py;
+			float distance = sqrtf(dx * dx + dy * dy);
+			if (distance < gate * MAX(track.size, det.size)) {
+				pairs[numPairs].distance = distance;
+				pairs[numPairs].track = t;
+				pairs[numPairs].detection = d;
+				++numPairs;
+			}
+		}
+	}
+
+	// greedy nearest neighbour
+	std::sort(pairs, pairs + numPairs);
+	for (int i = 0; i < numPairs; ++i) {
+		auto &track = tracks[pairs[i].track];
+		auto &det = detections[pairs[i].detection];
+		if (track.matched || det.trackingId >= 0) continue;
+
+		float steps = track.missed + 1;
+		track.vx = (track.vx + (det.x - track.x) / steps) / 2;
+		track.vy = (track.vy + (det.y - track.y) / steps) / 2;
+		track.x = det.x;
+		track.y = det.y;
+		track.size = det.size;
+		track.missed = 0;
+		track.matched = true;
+		det.trackingId = track.trackingId;
+	}
+
+	// keep unmatched tracks for a while
+	for (auto &track : tracks) {
+		if (track.used && !track.matched && ++track.missed > retryCount) {
+			track.used = false;
+		}
+	}
+
+	// new tracks
+	for (int d = 0; d < numDetections; ++d) {
+		auto &det = detections[d];
+		if (det.trackingId >= 0) continue;
+
+		for (auto &track : tracks) {
+			if (track.used) continue;
+			track.used = true;
+			track.matched = true;
+			track.trackingId = nextId++;
+			track.missed = 0;
+			track.x = det.x;
+			track.y = det.y;
+			track.vx = track.vy = 0;
+			track.size = det.size;
+			det.trackingId = track.trackingId;
+			break;
+		}
+	}
+}
+
+void ofxHvcP2HandTracker::linkBodies() {
+	for (int d = 0; d < numDetections; ++d) {
+		auto &det = detections[d];
+		float nearest = -1;
+		for (int b = 0; b < numBodies; ++b) {
+			auto &body = bodies[b];
+			float dx = det.x - body.x;
+			float dy = det.y - body.y;
+			float distance = sqrtf(dx * dx + dy * dy);
+			if (distance > bodyLinkDistance * body.size) continue;
+			if (nearest < 0 || distance < nearest) {
+				nearest = distance;
+				det.bodyTrackingId = body.trackingId;
+			}
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "ofMain.h"
+
+// Give tracking IDs to hands, which are not handled by STB.
+// Hands are associated with the nearest predicted track inside the gate,
+// and a track keeps its ID for retryCount frames without detection.
+// Each hand can be linked to the nearest tracked body.
+class ofxHvcP2HandTracker {
+public:
+	ofxHvcP2HandTracker();
+
+	static const int maxHands = 35;
+	static const int maxBodies = 35;
+	static const int maxTracks = 35;
+
+	// max distance to associate, as ratio of hand size
+	void setGate(float ratio);
+	// frames without detection before the track is removed
+	void setRetryCount(int count);
+	// max distance to link a body, as ratio of body size
+	void setBodyLinkDistance(float ratio);
+
+	// positions and sizes are HVC coordinates (1600x1200)
+	void beginFrame();
+	void addHand(int x, int y, int size);
+	void addBody(int trackingId, int x, int y, int size);
+	void endFrame();
+	void clear();
+
+	// results of the hand added in the same order, -1 if not available
+	int getTrackingId(int index) const;
+	int getBodyTrackingId(int index) const;
+
+private:
+	struct Detection {
+		int x, y, size;
+		int trackingId;
+		int bodyTrackingId;
+	};
+	struct Body {
+		int trackingId;
+		int x, y, size;
+	};
+	struct Track {
+		bool used = false;
+		bool matched = false;
+		int trackingId = -1;
+		int missed = 0;
+		float x = 0, y = 0;
+		float vx = 0, vy = 0;
+		int size = 0;
+	};
+	struct Pair {
+		float distance;
+		short track, detection;
+		bool operator <(const Pair &right) const { return distance < right.distance; }
+	};
+
+	void associate();
+	void linkBodies();
+
+	Detection detections[maxHands];
+	int numDetections;
+	Body bodies[maxBodies];
+	int numBodies;
+	Track tracks[maxTracks];
+	Pair pairs[maxTracks * maxHands];
+
+	float gate;
+	int retryCount;
+	float bodyLinkDistance;
+	int nextId;
+};
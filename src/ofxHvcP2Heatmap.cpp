@@ -0,0 +1,145 @@
+#include "ofxHvcP2Heatmap.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OFXHVCP2_HEATMAP_SSE
+#endif
+
+ofxHvcP2Heatmap::ofxHvcP2Heatmap() {
+	halfLife = 30;
+	maxValue = 0;
+	publishedMax = 0;
+	makeKernels();
+	setup(160, 120);
+}
+
+void ofxHvcP2Heatmap::setup(int _width, int _height) {
+	width = MAX(_width, 1);
+	height = MAX(_height, 1);
+	grid.assign(width * height, 0);
+	back.assign(width * height, 0);
+	mutex.lock();
+	front.assign(width * height, 0);
+	publishedMax = 0;
+	mutex.unlock();
+	hasTime = false;
+}
+
+void ofxHvcP2Heatmap::setHalfLife(float seconds) {
+	halfLife = MAX(seconds, 0);
+}
+
+void ofxHvcP2Heatmap::setMaxValue(float value) {
+	maxValue = MAX(value, 0);
+}
+
+void ofxHvcP2Heatmap::makeKernels() {
+	// sigma is half of the radius, so the edge is 2 sigma. peak is 1.
+	kernels.clear();
+	for (int r = 0; r <= maxRadius; ++r) {
+		kernelOffset[r] = kernels.size();
+		float sigma = MAX(r / 2.0f, 0.5f);
+		for (int y = -r; y <= r; ++y) {
+			for (int x = -r; x <= r; ++x) {
+				kernels.push_back(expf(-(x * x + y * y) / (2 * sigma * sigma)));
+			}
+		}
+	}
+}
+
+void ofxHvcP2Heatmap::decay(uint64_t time) {
+	if (!hasTime || halfLife <= 0 || time <= lastTime) {
+		if (!hasTime || time > lastTime) lastTime = time;
+		hasTime = true;
+		return;
+	}
+	float factor = powf(0.5f, (time - lastTime) / 1000.0f / halfLife);
+	lastTime = time;
+
+	float *p = grid.data();
+	int n = grid.size();
+	int i = 0;
+#ifdef OFXHVCP2_HEATMAP_SSE
+	const __m128 f = _mm_set1_ps(factor);
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_ps(p + i, _mm_mul_ps(_mm_loadu_ps(p + i), f));
+	}
+#endif
+	for (; i < n; ++i) {
+		p[i] *= factor;
+	}
+}
+
+void ofxHvcP2Heatmap::add(float x, float y, float radius, float weight) {
+	int cx = floorf(x * width);
+	int cy = floorf(y * height);
+	int r = ofClamp(radius * width + 0.5f, 0, maxRadius);
+	if (cx + r < 0 || cy + r < 0 || cx - r >= width || cy - r >= height) return;
+
+	const float *kernel = kernels.data() + kernelOffset[r];
+	int size = 2 * r + 1;
+	int x0 = MAX(cx - r, 0), x1 = MIN(cx + r, width - 1);
+	int y0 = MAX(cy - r, 0), y1 = MIN(cy + r, height - 1);
+	for (int gy = y0; gy <= y1; ++gy) {
+		float *row = grid.data() + gy * width;
+		const float *k = kernel + (gy - cy + r) * size - (cx - r);
+		for (int gx = x0; gx <= x1; ++gx) {
+			row[gx] += weight * k[gx];
+		}
+	}
+}
+
+void ofxHvcP2Heatmap::publish() {
+	const float *p = grid.data();
+	int n = grid.size();
+
+	float peak = maxValue;
+	if (peak <= 0) {
+		int i = 0;
+#ifdef OFXHVCP2_HEATMAP_SSE
+		__m128 m = _mm_setzero_ps();
+		for (; i + 4 <= n; i += 4) {
+			m = _mm_max_ps(m, _mm_loadu_ps(p + i));
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, m);
+		peak = MAX(MAX(lanes[0], lanes[1]), MAX(lanes[2], lanes[3]));
+#endif
+		for (; i < n; ++i) {
+			peak = MAX(peak, p[i]);
+		}
+	}
+
+	float scale = peak > 0 ? 255 / peak : 0;
+	for (int i = 0; i < n; ++i) {
+		back[i] = MIN(p[i] * scale, 255.0f);
+	}
+
+	mutex.lock();
+	std::swap(back, front);
+	publishedMax = peak;
+	mutex.unlock();
+}
+
+void ofxHvcP2Heatmap::clear() {
+	std::fill(grid.begin(), grid.end(), 0);
+	hasTime = false;
+}
+
+float ofxHvcP2Heatmap::getValue(int x, int y) const {
+	if (x < 0 || y < 0 || x >= width || y >= height) return 0;
+	return grid[y * width + x];
+}
+
+void ofxHvcP2Heatmap::getPixels(ofPixels &out) {
+	mutex.lock();
+	out.setFromPixels(front.data(), width, height, OF_IMAGE_GRAYSCALE);
+	mutex.unlock();
+}
+
+float ofxHvcP2Heatmap::getPublishedMax() {
+	mutex.lock();
+	float value = publishedMax;
+	mutex.unlock();
+	return value;
+}
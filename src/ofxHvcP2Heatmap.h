@@ -0,0 +1,59 @@
+#pragma once
+#include "ofMain.h"
+
+// Heatmap on a fixed float grid with exponential decay.
+// Points are added as Gaussian splats from kernels precomputed for each radius,
+// and decay is one multiplication per cell (SSE when available).
+// Coordinates are 0-1 of the mapped area, e.g. HVC coordinates, floor meters
+// (ofxHvcP2GroundProjector::project) or the display (ofxHvcP2GroundProjector::projectGaze).
+// One thread writes, publish() makes a grayscale image, and getPixels() can be called
+// from any thread. Readers only wait for a copy of the published image.
+class ofxHvcP2Heatmap {
+public:
+	ofxHvcP2Heatmap();
+
+	static const int maxRadius = 16; // cells
+
+	// grid cells, clears the heatmap. not thread safe
+	void setup(int width, int height);
+	// time to halve (sec), 0 is no decay
+	void setHalfLife(float seconds);
+	// value shown as white, 0 is the max of the grid
+	void setMaxValue(float value);
+
+	// time is elapsed millis, call once per frame before add()
+	void decay(uint64_t time);
+	// x, y are 0-1, radius is the ratio of the width
+	void add(float x, float y, float radius, float weight = 1);
+	// make the grayscale image for getPixels()
+	void publish();
+	void clear();
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	// writer thread only
+	float getValue(int x, int y) const;
+	const vector<float> &getGrid() const { return grid; }
+
+	// thread safe, published image
+	void getPixels(ofPixels &out);
+	float getPublishedMax();
+
+private:
+	void makeKernels();
+
+	int width, height;
+	vector<float> grid;
+	float halfLife;
+	float maxValue;
+	uint64_t lastTime;
+	bool hasTime;
+
+	// kernel of radius r is (2r+1)^2 values from kernelOffset[r]
+	vector<float> kernels;
+	int kernelOffset[maxRadius + 1];
+
+	vector<unsigned char> back, front;
+	float publishedMax;
+	ofMutex mutex;
+};
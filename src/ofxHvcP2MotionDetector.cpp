@@ -0,0 +1,158 @@
+#include "ofxHvcP2MotionDetector.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFXHVCP2_MOTION_SSE2
+#endif
+
+ofxHvcP2MotionDetector::ofxHvcP2MotionDetector() {
+	pixelThreshold = 20;
+	cellThreshold = 0.15f;
+	learningShift = 4;
+	width = height = 0;
+	cellsX = cellsY = 0;
+	hasBackground = false;
+	score = 0;
+	rects.reserve(maxRects);
+}
+
+void ofxHvcP2MotionDetector::setPixelThreshold(int threshold) {
+	pixelThreshold = ofClamp(threshold, 1, 255);
+}
+
+void ofxHvcP2MotionDetector::setCellThreshold(float ratio) {
+	cellThreshold = ofClamp(ratio, 0, 1);
+}
+
+void ofxHvcP2MotionDetector::setLearningShift(int shift) {
+	learningShift = ofClamp(shift, 1, 8);
+}
+
+float ofxHvcP2MotionDetector::update(const unsigned char *image, int _width, int _height) {
+	if (image == NULL || _width <= 0 || _height <= 0) return score;
+
+	if (_width != width || _height != height) {
+		allocate(_width, _height);
+	}
+
+	int numPixels = width * height;
+	if (!hasBackground) {
+		for (int i = 0; i < numPixels; ++i) {
+			background[i] = image[i] << 8;
+			backgroundU8[i] = image[i];
+		}
+		hasBackground = true;
+		score = 0;
+		rects.clear();
+		return score;
+	}
+
+	countChanged(image);
+	findRects();
+
+	// running average background
+	for (int i = 0; i < numPixels; ++i) {
+		int bg = background[i];
+		bg += ((image[i] << 8) - bg) >> learningShift;
+		background[i] = (unsigned short)bg;
+		backgroundU8[i] = (unsigned char)(bg >> 8);
+	}
+	return score;
+}
+
+void ofxHvcP2MotionDetector::reset() {
+	hasBackground = false;
+	score = 0;
+	rects.clear();
+}
+
+void ofxHvcP2MotionDetector::allocate(int _width, int _height) {
+	width = _width;
+	height = _height;
+	cellsX = (width + cellSize - 1) / cellSize;
+	cellsY = (height + cellSize - 1) / cellSize;
+	background.assign(width * height, 0);
+	backgroundU8.assign(width * height, 0);
+	cellCount.assign(cellsX * cellsY, 0);
+	cellLabel.assign(cellsX * cellsY, 0);
+	cellStack.resize(cellsX * cellsY);
+	hasBackground = false;
+}
+
+void ofxHvcP2MotionDetector::countChanged(const unsigned char *image) {
+	std::fill(cellCount.begin(), cellCount.end(), 0);
+	int total = 0;
+
+	for (int y = 0; y < height; ++y) {
+		const unsigned char *src = image + y * width;
+		const unsigned char *bg = backgroundU8.data() + y * width;
+		unsigned short *cells = cellCount.data() + (y / cellSize) * cellsX;
+		int x = 0;
+
+#ifdef OFXHVCP2_MOTION_SSE2
+		// 16 pixels = 2 cells per step. sad of 0/1 mask gives count of each 8 pixels.
+		const __m128i threshold = _mm_set1_epi8((char)pixelThreshold);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi8(1);
+		for (; x + 16 <= width; x += 16) {
+			__m128i a = _mm_loadu_si128((const __m128i *)(src + x));
+			__m128i b = _mm_loadu_si128((const __m128i *)(bg + x));
+			__m128i diff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+			__m128i still = _mm_cmpeq_epi8(_mm_subs_epu8(diff, threshold), zero);
+			__m128i changed = _mm_andnot_si128(still, one);
+			__m128i sad = _mm_sad_epu8(changed, zero);
+			int low = _mm_cvtsi128_si32(sad);
+			int high = _mm_cvtsi128_si32(_mm_srli_si128(sad, 8));
+			cells[x / cellSize] += low;
+			cells[x / cellSize + 1] += high;
+			total += low + high;
+		}
+#endif
+		for (; x < width; ++x) {
+			int d = src[x] - bg[x];
+			if (d > pixelThreshold || -d > pixelThreshold) {
+				++cells[x / cellSize];
+				++total;
+			}
+		}
+	}
+
+	score = (float)total / (width * height);
+}
+
+void ofxHvcP2MotionDetector::findRects() {
+	rects.clear();
+	int activeCount = MAX((int)(cellThreshold * cellSize * cellSize), 1);
+	std::fill(cellLabel.begin(), cellLabel.end(), 0);
+	float scale = 1600.0f / width;
+
+	// 4-connected components of active cells
+	for (int start = 0; start < cellsX * cellsY; ++start) {
+		if (cellLabel[start] != 0 || cellCount[start] < activeCount) continue;
+		if ((int)rects.size() >= maxRects) break;
+
+		int minX = cellsX, minY = cellsY, maxX = -1, maxY = -1;
+		int stackSize = 0;
+		cellStack[stackSize++] = start;
+		cellLabel[start] = 1;
+		while (stackSize > 0) {
+			int c = cellStack[--stackSize];
+			int cx = c % cellsX;
+			int cy = c / cellsX;
+			minX = MIN(minX, cx);
+			maxX = MAX(maxX, cx);
+			minY = MIN(minY, cy);
+			maxY = MAX(maxY, cy);
+
+			int neighbours[4] = { cx > 0 ? c - 1 : -1, cx < cellsX - 1 ? c + 1 : -1, cy > 0 ? c - cellsX : -1, cy < cellsY - 1 ? c + cellsX : -1 };
+			for (int n : neighbours) {
+				if (n < 0 || cellLabel[n] != 0 || cellCount[n] < activeCount) continue;
+				cellLabel[n] = 1;
+				cellStack[stackSize++] = n;
+			}
+		}
+
+		rects.push_back(ofRectangle(minX * cellSize * scale, minY * cellSize * scale,
+			(maxX - minX + 1) * cellSize * scale, (maxY - minY + 1) * cellSize * scale));
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "ofMain.h"
+
+// Cheap motion estimation on grayscale image (QVGA_HALF is enough).
+// Each frame is compared with a running average background.
+// Changed pixels are counted per cell, and connected cells become motion rects.
+class ofxHvcP2MotionDetector {
+public:
+	ofxHvcP2MotionDetector();
+
+	static const int cellSize = 8;
+	static const int maxRects = 16;
+
+	// pixel difference to be treated as changed (0-255)
+	void setPixelThreshold(int threshold);
+	// ratio of changed pixels in a cell to be treated as moving
+	void setCellThreshold(float ratio);
+	// background learning speed (1/2^shift per frame)
+	void setLearningShift(int shift);
+
+	// return motion score (ratio of changed pixels, 0-1)
+	float update(const unsigned char *image, int width, int height);
+	void reset();
+
+	float getScore() const { return score; }
+	// motion rects in HVC coordinates (1600x1200), top-left origin
+	const vector<ofRectangle> &getRects() const { return rects; }
+
+private:
+	void allocate(int width, int height);
+	void countChanged(const unsigned char *image);
+	void findRects();
+
+	int pixelThreshold;
+	float cellThreshold;
+	int learningShift;
+
+	int width, height;
+	int cellsX, cellsY;
+	bool hasBackground;
+	float score;
+
+	vector<unsigned short> background; // 8.8 fixed point
+	vector<unsigned char> backgroundU8;
+	vector<unsigned short> cellCount;
+	vector<short> cellLabel;
+	vector<int> cellStack;
+	vector<ofRectangle> rects;
+};
@@ -0,0 +1,136 @@
+#include "ofxHvcP2MotionModel.h"
+
+// velocity is unknown when a track appears
+static const float initialVelocityVariance = 400.0f * 400.0f;
+
+ofxHvcP2MotionModel::ofxHvcP2MotionModel() {
+	processNoise = 300;
+	measurementNoise = 15;
+	lostTime = 1000;
+	maxPredictionTime = 500;
+	frameTime = 0;
+}
+
+void ofxHvcP2MotionModel::setProcessNoise(float acceleration) {
+	processNoise = MAX(acceleration, 0.0f);
+}
+
+void ofxHvcP2MotionModel::setMeasurementNoise(float noise) {
+	measurementNoise = MAX(noise, 0.1f);
+}
+
+void ofxHvcP2MotionModel::setLostTime(uint64_t millis) {
+	lostTime = millis;
+}
+
+void ofxHvcP2MotionModel::setMaxPredictionTime(uint64_t millis) {
+	maxPredictionTime = millis;
+}
+
+void ofxHvcP2MotionModel::beginFrame(uint64_t time) {
+	frameTime = time;
+}
+
+void ofxHvcP2MotionModel::update(int trackingId, float x, float y, float size) {
+	if (trackingId < 0) return;
+
+	Track *track = NULL;
+	Track *freeTrack = NULL;
+	for (auto &t : tracks) {
+		if (t.used && t.trackingId == trackingId) {
+			track = &t;
+			break;
+		}
+		if (!t.used && freeTrack == NULL) freeTrack = &t;
+	}
+
+	float z[3] = { x, y, size };
+	float r = measurementNoise * measurementNoise;
+
+	// new track
+	if (track == NULL) {
+		if (freeTrack == NULL) return;
+		track = freeTrack;
+		track->used = true;
+		track->trackingId = trackingId;
+		track->time = frameTime;
+		for (int i = 0; i < 3; ++i) track->axis[i].reset(z[i], r);
+		return;
+	}
+
+	float dt = frameTime > track->time ? (frameTime - track->time) / 1000.0f : 0.0f;
+	float q = processNoise * processNoise;
+	for (int i = 0; i < 3; ++i) {
+		track->axis[i].predict(dt, q);
+		track->axis[i].correct(z[i], r);
+	}
+	track->time = frameTime;
+}
+
+void ofxHvcP2MotionModel::endFrame() {
+	for (auto &t : tracks) {
+		if (t.used && frameTime > t.time + lostTime) {
+			t.used = false;
+		}
+	}
+}
+
+void ofxHvcP2MotionModel::clear() {
+	for (auto &t : tracks) t.used = false;
+}
+
+bool ofxHvcP2MotionModel::predict(int trackingId, uint64_t time, ofVec3f &out) const {
+	const Track *track = find(trackingId);
+	if (track == NULL) return false;
+
+	uint64_t elapsed = time > track->time ? MIN(time - track->time, maxPredictionTime) : 0;
+	float dt = elapsed / 1000.0f;
+	out.x = track->axis[0].value + track->axis[0].velocity * dt;
+	out.y = track->axis[1].value + track->axis[1].velocity * dt;
+	out.z = MAX(track->axis[2].value + track->axis[2].velocity * dt, 0.0f);
+	return true;
+}
+
+bool ofxHvcP2MotionModel::getVelocity(int trackingId, ofVec3f &out) const {
+	const Track *track = find(trackingId);
+	if (track == NULL) return false;
+
+	out.set(track->axis[0].velocity, track->axis[1].velocity, track->axis[2].velocity);
+	return true;
+}
+
+const ofxHvcP2MotionModel::Track *ofxHvcP2MotionModel::find(int trackingId) const {
+	for (auto &t : tracks) {
+		if (t.used && t.trackingId == trackingId) return &t;
+	}
+	return NULL;
+}
+
+void ofxHvcP2MotionModel::Axis::reset(float z, float r) {
+	value = z;
+	velocity = 0;
+	p00 = r;
+	p01 = 0;
+	p11 = initialVelocityVariance;
+}
+
+void ofxHvcP2MotionModel::Axis::predict(float dt, float q) {
+	// white noise acceleration
+	float dt2 = dt * dt;
+	value += velocity * dt;
+	p00 += dt * (2 * p01 + dt * p11) + q * dt2 * dt2 / 4;
+	p01 += dt * p11 + q * dt2 * dt / 2;
+	p11 += q * dt2;
+}
+
+void ofxHvcP2MotionModel::Axis::correct(float z, float r) {
+	float s = p00 + r;
+	float k0 = p00 / s;
+	float k1 = p01 / s;
+	float innovation = z - value;
+	value += k0 * innovation;
+	velocity += k1 * innovation;
+	p11 -= k1 * p01;
+	p01 -= k1 * p00;
+	p00 -= k0 * p00;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "ofMain.h"
+
+// Constant velocity Kalman filter of each tracking ID.
+// x, y and size are filtered independently (value and velocity per axis),
+// so the state can be extrapolated to any host time between device frames.
+class ofxHvcP2MotionModel {
+public:
+	ofxHvcP2MotionModel();
+
+	static const int maxTracks = 35;
+
+	// standard deviation of acceleration (HVC coordinate / sec^2)
+	void setProcessNoise(float acceleration);
+	// standard deviation of measured position and size (HVC coordinate)
+	void setMeasurementNoise(float noise);
+	// track is removed when it is not updated for this time (millis)
+	void setLostTime(uint64_t millis);
+	// extrapolation is limited to this time after the last measurement (millis)
+	void setMaxPredictionTime(uint64_t millis);
+
+	// time is elapsed millis when the frame was captured
+	void beginFrame(uint64_t time);
+	void update(int trackingId, float x, float y, float size);
+	void endFrame();
+	void clear();
+
+	// x, y and size at time (elapsed millis). false if the tracking ID is not tracked
+	bool predict(int trackingId, uint64_t time, ofVec3f &out) const;
+	// velocity of x, y and size (HVC coordinate / sec)
+	bool getVelocity(int trackingId, ofVec3f &out) const;
+
+private:
+	struct Axis {
+		float value, velocity;
+		float p00, p01, p11; // covariance
+		void reset(float z, float r);
+		void predict(float dt, float q);
+		void correct(float z, float r);
+	};
+	struct Track {
+		bool used = false;
+		int trackingId = -1;
+		uint64_t time = 0;
+		Axis axis[3];
+	};
+	Track tracks[maxTracks];
+
+	const Track *find(int trackingId) const;
+
+	float processNoise;
+	float measurementNoise;
+	uint64_t lostTime;
+	uint64_t maxPredictionTime;
+	uint64_t frameTime;
+};
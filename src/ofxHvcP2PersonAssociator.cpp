@@ -0,0 +1,241 @@
+#include "ofxHvcP2PersonAssociator.h"
+
+// cost of leaving a face or body alone, pairs above this are not joined
+static const float unassignedCost = 1.0f;
+// typical face size as ratio of body size
+static const float faceSizeRatio = 0.35f;
+
+ofxHvcP2PersonAssociator::ofxHvcP2PersonAssociator() {
+	faceOffset = 0.3f;
+	handReach = 1.5f;
+	continuityBonus = 0.5f;
+	numLinks = 0;
+	nextId = 0;
+	persons.reserve(maxPersons);
+}
+
+void ofxHvcP2PersonAssociator::setFaceOffset(float ratio) {
+	faceOffset = ratio;
+}
+
+void ofxHvcP2PersonAssociator::setHandReach(float ratio) {
+	handReach = MAX(ratio, 0.0f);
+}
+
+void ofxHvcP2PersonAssociator::setContinuityBonus(float ratio) {
+	continuityBonus = ofClamp(ratio, 0, 1);
+}
+
+void ofxHvcP2PersonAssociator::update(const ofxHvcP2::Faces &faces, const ofxHvcP2::Bodies &bodies, const ofxHvcP2::Hands &hands) {
+	int numFaces = MIN((int)faces.size(), maxSize);
+	int numBodies = MIN((int)bodies.size(), maxSize);
+
+	// solver needs rows <= cols
+	bool transposed = numFaces > numBodies;
+	int rows = transposed ? numBodies : numFaces;
+	int cols = transposed ? numFaces : numBodies;
+	for (int f = 0; f < numFaces; ++f) {
+		for (int b = 0; b < numBodies; ++b) {
+			float c = getFaceCost(faces[f], bodies[b]);
+			if (wasPaired(faces[f].trackingId, bodies[b].trackingId)) c *= continuityBonus;
+			c = MIN(c, unassignedCost);
+			if (transposed) cost[b][f] = c;
+			else cost[f][b] = c;
+		}
+	}
+	if (rows > 0) solve(rows, cols);
+
+	bool faceUsed[maxSize] = {};
+	bool bodyUsed[maxSize] = {};
+	persons.clear();
+	for (int r = 0; r < rows; ++r) {
+		int c = assignment[r];
+		if (c < 0 || cost[r][c] >= unassignedCost) continue;
+		int f = transposed ? c : r;
+		int b = transposed ? r : c;
+
+		persons.push_back(Person());
+		auto &person = persons.back();
+		person.hasFace = true;
+		person.face = faces[f];
+		person.hasBody = true;
+		person.body = bodies[b];
+		person.position = bodies[b].position;
+		faceUsed[f] = bodyUsed[b] = true;
+	}
+	for (int b = 0; b < numBodies; ++b) {
+		if (bodyUsed[b]) continue;
+		persons.push_back(Person());
+		auto &person = persons.back();
+		person.hasBody = true;
+		person.body = bodies[b];
+		person.position = bodies[b].position;
+	}
+	for (int f = 0; f < numFaces; ++f) {
+		if (faceUsed[f]) continue;
+		persons.push_back(Person());
+		auto &person = persons.back();
+		person.hasFace = true;
+		person.face = faces[f];
+		person.position = faces[f].position;
+	}
+
+	assignHands(hands);
+	assignIds();
+}
+
+void ofxHvcP2PersonAssociator::clear() {
+	persons.clear();
+	numLinks = 0;
+}
+
+float ofxHvcP2PersonAssociator::getFaceCost(const ofxHvcP2::Face &face, const ofxHvcP2::Body &body) const {
+	float size = MAX(body.size, 1);
+	float dx = (face.position.x - body.position.x) / size;
+	float dy = (face.position.y - body.position.y) / size;
+	float ratio = face.size / size;
+
+	// face must be inside the upper part of the body
+	if (fabsf(dx) > 0.5f || dy < -0.5f - faceOffset || dy > 0.1f) return unassignedCost;
+	if (ratio < faceSizeRatio / 4 || ratio > faceSizeRatio * 3) return unassignedCost;
+
+	dy += faceOffset;
+	return sqrtf(dx * dx + dy * dy) + 0.5f * fabsf(logf(ratio / faceSizeRatio));
+}
+
+bool ofxHvcP2PersonAssociator::wasPaired(int faceTrackingId, int bodyTrackingId) const {
+	if (faceTrackingId < 0 || bodyTrackingId < 0) return false;
+	for (int i = 0; i < numLinks; ++i) {
+		if (links[i].faceTrackingId == faceTrackingId && links[i].bodyTrackingId == bodyTrackingId) return true;
+	}
+	return false;
+}
+
+void ofxHvcP2PersonAssociator::solve(int rows, int cols) {
+	// Hungarian method with potentials, O(rows^2 * cols)
+	const float inf = 1e9f;
+	for (int j = 0; j <= cols; ++j) {
+		v[j] = 0;
+		p[j] = 0;
+	}
+	for (int i = 0; i <= rows; ++i) u[i] = 0;
+
+	for (int i = 1; i <= rows; ++i) {
+		p[0] = i;
+		int j0 = 0;
+		for (int j = 0; j <= cols; ++j) {
+			minv[j] = inf;
+			used[j] = false;
+		}
+		do {
+			used[j0] = true;
+			int i0 = p[j0];
+			int j1 = 0;
+			float delta = inf;
+			for (int j = 1; j <= cols; ++j) {
+				if (used[j]) continue;
+				float cur = cost[i0 - 1][j - 1] - u[i0] - v[j];
+				if (cur < minv[j]) {
+					minv[j] = cur;
+					way[j] = j0;
+				}
+				if (minv[j] < delta) {
+					delta = minv[j];
+					j1 = j;
+				}
+			}
+			for (int j = 0; j <= cols; ++j) {
+				if (used[j]) {
+					u[p[j]] += delta;
+					v[j] -= delta;
+				}
+				else {
+					minv[j] -= delta;
+				}
+			}
+			j0 = j1;
+		} while (p[j0] != 0);
+		do {
+			int j1 = way[j0];
+			p[j0] = p[j1];
+			j0 = j1;
+		} while (j0 != 0);
+	}
+
+	for (int i = 0; i < rows; ++i) assignment[i] = -1;
+	for (int j = 1; j <= cols; ++j) {
+		if (p[j] != 0) assignment[p[j] - 1] = j - 1;
+	}
+}
+
+void ofxHvcP2PersonAssociator::assignHands(const ofxHvcP2::Hands &hands) {
+	struct Pair {
+		float distance;
+		short person, hand;
+		bool operator <(const Pair &right) const { return distance < right.distance; }
+	};
+	static const int maxHands = 35;
+	Pair pairs[maxPersons * maxHands];
+	int numPairs = 0;
+
+	int numHands = MIN((int)hands.size(), maxHands);
+	for (int i = 0; i < (int)persons.size(); ++i) {
+		auto &person = persons[i];
+		// reach from the face is used when the body is not detected
+		float reach = person.hasBody ? handReach * person.body.size : handReach * person.face.size / faceSizeRatio;
+		for (int h = 0; h < numHands; ++h) {
+			float dx = hands[h].position.x - person.position.x;
+			float dy = hands[h].position.y - person.position.y;
+			float distance = sqrtf(dx * dx + dy * dy);
+			if (distance > reach) continue;
+
+			// hand tracker already linked the hand to this body
+			if (person.hasBody && hands[h].bodyTrackingId >= 0 && hands[h].bodyTrackingId == person.body.trackingId) {
+				distance *= 0.5f;
+			}
+			pairs[numPairs].distance = distance;
+			pairs[numPairs].person = i;
+			pairs[numPairs].hand = h;
+			++numPairs;
+		}
+	}
+
+	std::sort(pairs, pairs + numPairs);
+	bool handUsed[maxHands] = {};
+	for (int i = 0; i < numPairs; ++i) {
+		auto &person = persons[pairs[i].person];
+		if (handUsed[pairs[i].hand] || person.numHands >= maxHandsPerPerson) continue;
+		person.hands[person.numHands++] = hands[pairs[i].hand];
+		handUsed[pairs[i].hand] = true;
+	}
+}
+
+void ofxHvcP2PersonAssociator::assignIds() {
+	for (int i = 0; i < (int)persons.size(); ++i) {
+		auto &person = persons[i];
+		int bodyId = person.hasBody ? person.body.trackingId : -1;
+		int faceId = person.hasFace ? person.face.trackingId : -1;
+
+		// body is more stable than face
+		int id = -1;
+		for (int l = 0; l < numLinks && id < 0; ++l) {
+			if (bodyId >= 0 && links[l].bodyTrackingId == bodyId) id = links[l].personId;
+		}
+		for (int l = 0; l < numLinks && id < 0; ++l) {
+			if (faceId >= 0 && links[l].faceTrackingId == faceId) id = links[l].personId;
+		}
+		// the previous person is split
+		for (int j = 0; j < i && id >= 0; ++j) {
+			if (persons[j].id == id) id = -1;
+		}
+		person.id = id >= 0 ? id : nextId++;
+	}
+
+	numLinks = 0;
+	for (auto &person : persons) {
+		auto &link = links[numLinks++];
+		link.faceTrackingId = person.hasFace ? person.face.trackingId : -1;
+		link.bodyTrackingId = person.hasBody ? person.body.trackingId : -1;
+		link.personId = person.id;
+	}
+}
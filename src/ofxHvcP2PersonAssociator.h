@@ -0,0 +1,69 @@
+#pragma once
+#include "ofxHvcP2.h"
+
+// Join faces, bodies and hands of the same frame into persons.
+// Face and body are matched by an assignment solver (face should be in the upper
+// part of the body), pairs of the previous frame are preferred, and hands are
+// given to the nearest person within arm's reach (max 2 per person).
+// Person ID is kept while its body or face tracking ID continues.
+class ofxHvcP2PersonAssociator {
+public:
+	ofxHvcP2PersonAssociator();
+
+	static const int maxPersons = 70; // 35 faces + 35 bodies
+	static const int maxHandsPerPerson = 2;
+
+	struct Person {
+		int id = -1;
+		bool hasFace = false;
+		bool hasBody = false;
+		ofxHvcP2::Face face;
+		ofxHvcP2::Body body;
+		int numHands = 0;
+		ofxHvcP2::Hand hands[maxHandsPerPerson];
+		ofxHvcP2::vec2i position; // body center, or face center without body
+	};
+	typedef vector<Person> Persons;
+
+	// expected face center above the body center, as ratio of body size
+	void setFaceOffset(float ratio);
+	// max distance of hands from the body center, as ratio of body size
+	void setHandReach(float ratio);
+	// cost ratio for pairs which are joined in the previous frame (0-1)
+	void setContinuityBonus(float ratio);
+
+	void update(const ofxHvcP2::Faces &faces, const ofxHvcP2::Bodies &bodies, const ofxHvcP2::Hands &hands);
+	void clear();
+
+	const Persons &getPersons() const { return persons; }
+
+private:
+	float getFaceCost(const ofxHvcP2::Face &face, const ofxHvcP2::Body &body) const;
+	bool wasPaired(int faceTrackingId, int bodyTrackingId) const;
+	void solve(int rows, int cols); // result in assignment
+	void assignHands(const ofxHvcP2::Hands &hands);
+	void assignIds();
+
+	static const int maxSize = 35;
+	float cost[maxSize][maxSize];
+	int assignment[maxSize];
+	// solver work area
+	float u[maxSize + 1], v[maxSize + 1], minv[maxSize + 1];
+	int p[maxSize + 1], way[maxSize + 1];
+	bool used[maxSize + 1];
+
+	struct Link {
+		int faceTrackingId;
+		int bodyTrackingId;
+		int personId;
+	};
+	Link links[maxPersons];
+	int numLinks;
+
+	Persons persons;
+	int nextId;
+
+	float faceOffset;
+	float handReach;
+	float continuityBonus;
+};
@@ -0,0 +1,192 @@
+#include "ofxHvcP2Pipeline.h"
+
+// weight of the new value of the average time
+static const float timingSmoothing = 0.1f;
+
+ofxHvcP2Pipeline::ofxHvcP2Pipeline() : running(false), busy(false), remaining(0), queued(0) {
+	startTime = 0;
+	runTime = 0;
+}
+
+ofxHvcP2Pipeline::~ofxHvcP2Pipeline() {
+	stop();
+}
+
+void ofxHvcP2Pipeline::setup(int numWorkers) {
+	stop();
+	running = true;
+	numWorkers = MAX(numWorkers, 1);
+	for (int i = 0; i < numWorkers; ++i) {
+		workers.push_back(unique_ptr<Worker>(new Worker()));
+	}
+	for (int i = 0; i < numWorkers; ++i) {
+		workers[i]->thread = std::thread(&ofxHvcP2Pipeline::workerFunction, this, i);
+	}
+}
+
+void ofxHvcP2Pipeline::stop() {
+	if (workers.empty()) return;
+	wait();
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+	sleepCondition.notify_all();
+	for (auto &w : workers) {
+		if (w->thread.joinable()) w->thread.join();
+	}
+	workers.clear();
+}
+
+int ofxHvcP2Pipeline::addStage(const string &name, std::function<void()> func, const vector<int> &dependencies) {
+	// dependencies have to be added before, so the graph has no cycle
+	if (busy || !func) return -1;
+	int index = stages.size();
+	for (int d : dependencies) {
+		if (d < 0 || d >= index) return -1;
+	}
+
+	unique_ptr<Stage> stage(new Stage());
+	stage->name = name;
+	stage->func = func;
+	stage->numDependencies = dependencies.size();
+	stage->timing.name = name;
+	for (int d : dependencies) {
+		stages[d]->successors.push_back(index);
+	}
+	stages.push_back(std::move(stage));
+	return index;
+}
+
+int ofxHvcP2Pipeline::findStage(const string &name) const {
+	for (int i = 0; i < (int)stages.size(); ++i) {
+		if (stages[i]->name == name) return i;
+	}
+	return -1;
+}
+
+void ofxHvcP2Pipeline::clearStages() {
+	wait();
+	stages.clear();
+}
+
+void ofxHvcP2Pipeline::setFinishedCallback(std::function<void()> callback) {
+	finishedCallback = callback;
+}
+
+bool ofxHvcP2Pipeline::start() {
+	if (workers.empty() || stages.empty()) return false;
+	bool expected = false;
+	if (!busy.compare_exchange_strong(expected, true)) return false;
+
+	startTime = ofGetElapsedTimeMicros();
+	remaining = stages.size();
+	for (auto &s : stages) s->pending = s->numDependencies;
+
+	// stages without dependency are spread to the workers
+	int next = 0;
+	for (int i = 0; i < (int)stages.size(); ++i) {
+		if (stages[i]->numDependencies == 0) {
+			push(next, i);
+			next = (next + 1) % workers.size();
+		}
+	}
+	return true;
+}
+
+void ofxHvcP2Pipeline::wait() {
+	std::unique_lock<std::mutex> lock(sleepMutex);
+	finishedCondition.wait(lock, [this] { return !busy.load(); });
+}
+
+void ofxHvcP2Pipeline::getTimings(vector<Timing> &out) {
+	out.clear();
+	timingMutex.lock();
+	for (auto &s : stages) out.push_back(s->timing);
+	timingMutex.unlock();
+}
+
+float ofxHvcP2Pipeline::getRunTime() {
+	timingMutex.lock();
+	float value = runTime;
+	timingMutex.unlock();
+	return value;
+}
+
+void ofxHvcP2Pipeline::workerFunction(int index) {
+	while (true) {
+		int stage;
+		if (pop(index, stage)) {
+			execute(index, stage);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepCondition.wait(lock, [this] { return queued.load() > 0 || !running.load(); });
+		if (!running && queued.load() == 0) return;
+	}
+}
+
+bool ofxHvcP2Pipeline::pop(int index, int &stage) {
+	// own queue from the back (LIFO, hot in cache), others from the front
+	int n = workers.size();
+	for (int i = 0; i < n; ++i) {
+		Worker &w = *workers[(index + i) % n];
+		std::lock_guard<std::mutex> lock(w.mutex);
+		if (w.queue.empty()) continue;
+		if (i == 0) {
+			stage = w.queue.back();
+			w.queue.pop_back();
+		}
+		else {
+			stage = w.queue.front();
+			w.queue.pop_front();
+		}
+		--queued;
+		return true;
+	}
+	return false;
+}
+
+void ofxHvcP2Pipeline::push(int index, int stage) {
+	{
+		std::lock_guard<std::mutex> lock(workers[index]->mutex);
+		workers[index]->queue.push_back(stage);
+	}
+	++queued;
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	sleepCondition.notify_all();
+}
+
+void ofxHvcP2Pipeline::execute(int index, int stageIndex) {
+	Stage &stage = *stages[stageIndex];
+	uint64_t t0 = ofGetElapsedTimeMicros();
+	stage.func();
+	uint64_t t1 = ofGetElapsedTimeMicros();
+
+	timingMutex.lock();
+	Timing &t = stage.timing;
+	t.last = t1 - t0;
+	t.average = t.runs == 0 ? t.last : t.average + timingSmoothing * (t.last - t.average);
+	t.max = MAX(t.max, t.last);
+	++t.runs;
+	timingMutex.unlock();
+
+	// ready successors go to this worker, other workers steal them
+	for (int s : stage.successors) {
+		if (--stages[s]->pending == 0) push(index, s);
+	}
+
+	if (--remaining == 0) {
+		timingMutex.lock();
+		runTime = t1 - startTime;
+		timingMutex.unlock();
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			busy = false;
+		}
+		finishedCondition.notify_all();
+		if (finishedCallback) finishedCallback();
+	}
+}
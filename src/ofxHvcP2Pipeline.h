@@ -0,0 +1,84 @@
+#pragma once
+#include "ofMain.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+
+// Graph of processing stages run on a small work stealing pool.
+// A stage starts when all of its dependencies are finished, so independent stages run in parallel.
+// Each worker pops from the back of its own queue and steals from the front of the others.
+// One run of the graph at a time, start() returns false while running.
+class ofxHvcP2Pipeline {
+public:
+	ofxHvcP2Pipeline();
+	~ofxHvcP2Pipeline();
+
+	struct Timing {
+		string name;
+		float last = 0;    // micros
+		float average = 0; // micros, EMA
+		float max = 0;     // micros
+		uint64_t runs = 0;
+	};
+
+	// start workers
+	void setup(int numWorkers = 2);
+	// wait for the current run and stop workers
+	void stop();
+
+	// not while running. dependencies are indices of added stages. return index, -1 if invalid
+	int addStage(const string &name, std::function<void()> func, const vector<int> &dependencies = vector<int>());
+	int findStage(const string &name) const;
+	int getNumStages() const { return stages.size(); }
+	void clearStages();
+
+	// called from the worker which finished the last stage, after the run is finished
+	void setFinishedCallback(std::function<void()> callback);
+
+	// run all stages once in the background
+	bool start();
+	bool isBusy() const { return busy.load(); }
+	void wait();
+
+	void getTimings(vector<Timing> &out);
+	// wall time of the last run, from start() to the end of the last stage (micros)
+	float getRunTime();
+
+private:
+	struct Stage {
+		string name;
+		std::function<void()> func;
+		vector<int> successors;
+		int numDependencies = 0;
+		std::atomic<int> pending;
+		Timing timing;
+		Stage() : pending(0) {}
+	};
+	struct Worker {
+		std::thread thread;
+		std::mutex mutex;
+		std::deque<int> queue;
+	};
+
+	void workerFunction(int index);
+	bool pop(int index, int &stage);
+	void push(int index, int stage);
+	void execute(int index, int stage);
+
+	vector<unique_ptr<Stage>> stages;
+	vector<unique_ptr<Worker>> workers;
+	std::atomic<bool> running;
+	std::atomic<bool> busy;
+	std::atomic<int> remaining;
+	std::atomic<int> queued;
+	std::mutex sleepMutex;
+	std::condition_variable sleepCondition;
+	std::condition_variable finishedCondition;
+	std::function<void()> finishedCallback;
+
+	ofMutex timingMutex;
+	uint64_t startTime;
+	float runTime;
+};
@@ -0,0 +1,108 @@
+#include "ofxHvcP2PrivacyMask.h"
+
+ofxHvcP2PrivacyMask::ofxHvcP2PrivacyMask() {
+	mode = Blur;
+	strength = 0.2f;
+	margin = 1.3f;
+	image = NULL;
+	width = height = 0;
+}
+
+void ofxHvcP2PrivacyMask::setStrength(float ratio) {
+	strength = ofClamp(ratio, 0.01f, 1.0f);
+}
+
+void ofxHvcP2PrivacyMask::setMargin(float scale) {
+	margin = MAX(scale, 0.1f);
+}
+
+bool ofxHvcP2PrivacyMask::begin(unsigned char *_image, int _width, int _height) {
+	image = _image;
+	width = _width;
+	height = _height;
+	if (image == NULL || width <= 0 || height <= 0) {
+		image = NULL;
+		return false;
+	}
+
+	size_t needSize = (size_t)(width + 1) * (height + 1);
+	if (integral.size() < needSize) {
+		integral.resize(needSize);
+	}
+	return true;
+}
+
+void ofxHvcP2PrivacyMask::addRect(int x, int y, int size) {
+	if (image == NULL || size <= 0) return;
+
+	// HVC-P2 returns positions in 1600x1200
+	float scale = width / 1600.0f;
+	float half = size * scale * margin / 2;
+	int x0 = MAX((int)(x * scale - half), 0);
+	int y0 = MAX((int)(y * scale - half), 0);
+	int x1 = MIN((int)(x * scale + half + 1), width);
+	int y1 = MIN((int)(y * scale + half + 1), height);
+	if (x0 >= x1 || y0 >= y1) return;
+
+	int amount = MAX((int)(size * scale * strength), 2);
+	if (mode == Blur) blur(x0, y0, x1, y1, amount);
+	else pixelate(x0, y0, x1, y1, amount);
+}
+
+void ofxHvcP2PrivacyMask::blur(int x0, int y0, int x1, int y1, int radius) {
+	// integral image of the rectangle expanded by radius
+	int ix0 = MAX(x0 - radius, 0);
+	int iy0 = MAX(y0 - radius, 0);
+	int ix1 = MIN(x1 + radius, width);
+	int iy1 = MIN(y1 + radius, height);
+	int iw = ix1 - ix0 + 1;
+
+	uint32_t *sum = integral.data();
+	memset(sum, 0, sizeof(uint32_t) * iw);
+	for (int y = iy0; y < iy1; ++y) {
+		const unsigned char *src = image + y * width + ix0;
+		uint32_t *prev = sum + (y - iy0) * iw;
+		uint32_t *cur = prev + iw;
+		uint32_t rowSum = 0;
+		cur[0] = 0;
+		for (int x = 0; x < ix1 - ix0; ++x) {
+			rowSum += src[x];
+			cur[x + 1] = prev[x + 1] + rowSum;
+		}
+	}
+
+	// box average, window is clipped at the image border
+	for (int y = y0; y < y1; ++y) {
+		int wy0 = MAX(y - radius, iy0) - iy0;
+		int wy1 = MIN(y + radius + 1, iy1) - iy0;
+		const uint32_t *top = sum + wy0 * iw;
+		const uint32_t *bottom = sum + wy1 * iw;
+		unsigned char *dst = image + y * width;
+		for (int x = x0; x < x1; ++x) {
+			int wx0 = MAX(x - radius, ix0) - ix0;
+			int wx1 = MIN(x + radius + 1, ix1) - ix0;
+			uint32_t total = bottom[wx1] - bottom[wx0] - top[wx1] + top[wx0];
+			int area = (wx1 - wx0) * (wy1 - wy0);
+			dst[x] = (unsigned char)(total / area);
+		}
+	}
+}
+
+void ofxHvcP2PrivacyMask::pixelate(int x0, int y0, int x1, int y1, int block) {
+	for (int by = y0; by < y1; by += block) {
+		int by1 = MIN(by + block, y1);
+		for (int bx = x0; bx < x1; bx += block) {
+			int bx1 = MIN(bx + block, x1);
+
+			uint32_t total = 0;
+			for (int y = by; y < by1; ++y) {
+				const unsigned char *src = image + y * width;
+				for (int x = bx; x < bx1; ++x) total += src[x];
+			}
+			unsigned char mean = (unsigned char)(total / ((by1 - by) * (bx1 - bx)));
+			for (int y = by; y < by1; ++y) {
+				memset(image + y * width + bx, mean, bx1 - bx);
+			}
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "ofMain.h"
+
+// Anonymize rectangles of grayscale image in place.
+// Blur is a box filter calculated from integral image, so the cost per pixel
+// does not depend on the blur radius.
+class ofxHvcP2PrivacyMask {
+public:
+	ofxHvcP2PrivacyMask();
+
+	enum Mode {
+		Blur,
+		Pixelate
+	};
+
+	void setMode(Mode mode) { this->mode = mode; }
+	Mode getMode() const { return mode; }
+
+	// blur radius or pixel block size, as ratio of the rectangle size
+	void setStrength(float ratio);
+	// scale of the masked rectangle (1.0 is the detection size)
+	void setMargin(float scale);
+
+	// image must be kept until end of the frame
+	bool begin(unsigned char *image, int width, int height);
+	// position and size are HVC coordinates (1600x1200)
+	void addRect(int x, int y, int size);
+
+private:
+	void blur(int x0, int y0, int x1, int y1, int radius);
+	void pixelate(int x0, int y0, int x1, int y1, int block);
+
+	Mode mode;
+	float strength;
+	float margin;
+
+	unsigned char *image;
+	int width, height;
+	vector<uint32_t> integral;
+};
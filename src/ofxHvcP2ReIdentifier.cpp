@@ -0,0 +1,184 @@
+#include "ofxHvcP2ReIdentifier.h"
+
+ofxHvcP2ReIdentifier::ofxHvcP2ReIdentifier() {
+	maxGap = 5000;
+	positionGate = 2.0f;
+	frameTime = 0;
+	merges.reserve(maxTracks);
+	clear();
+}
+
+void ofxHvcP2ReIdentifier::setMaxGap(uint64_t millis) {
+	maxGap = millis;
+}
+
+void ofxHvcP2ReIdentifier::setPositionGate(float ratio) {
+	positionGate = MAX(ratio, 0.1f);
+}
+
+void ofxHvcP2ReIdentifier::beginFrame(uint64_t time) {
+	frameTime = time;
+	merges.clear();
+	for (auto &a : active) a.seen = false;
+}
+
+int ofxHvcP2ReIdentifier::addFace(int trackingId, int uid, int x, int y, int size, int age, int gender) {
+	if (trackingId < 0) return -1;
+	if (uid >= maxUid) uid = -1;
+
+	Active *slot = NULL;
+	Active *freeSlot = NULL;
+	for (auto &a : active) {
+		if (a.used && a.trackingId == trackingId) {
+			slot = &a;
+			break;
+		}
+		if (!a.used && freeSlot == NULL) freeSlot = &a;
+	}
+
+	bool isNew = slot == NULL;
+	if (isNew) {
+		if (freeSlot == NULL) return trackingId;
+		slot = freeSlot;
+		*slot = Active();
+		slot->used = true;
+		slot->trackingId = trackingId;
+		slot->person.identity = trackingId;
+	}
+	slot->seen = true;
+
+	auto &p = slot->person;
+	bool uidFound = p.uid < 0 && uid >= 0;
+	p.x = x;
+	p.y = y;
+	p.size = size;
+	if (uid >= 0) p.uid = uid;
+	if (age >= 0) p.age = age;
+	if (gender >= 0) p.gender = gender;
+
+	// STB keeps the tracking ID while retrying, the track is back
+	if (isNew) {
+		for (int e = head; e >= 0; e = gallery[e].next) {
+			if (gallery[e].trackingId != trackingId) continue;
+			p.identity = gallery[e].person.identity;
+			remove(e);
+			return p.identity;
+		}
+	}
+
+	// recognition usually completes some frames after the track appears
+	bool notMerged = p.identity == trackingId;
+	if (isNew || (uidFound && notMerged)) {
+		int entry = findEntry(p);
+		if (entry >= 0 && (isNew || gallery[entry].person.uid == p.uid)) {
+			merge(*slot, entry);
+		}
+	}
+	return p.identity;
+}
+
+void ofxHvcP2ReIdentifier::endFrame() {
+	// lost tracks go to the gallery
+	for (auto &a : active) {
+		if (!a.used || a.seen) continue;
+		a.used = false;
+
+		if (a.person.uid >= 0 && uidEntry[a.person.uid] >= 0) {
+			remove(uidEntry[a.person.uid]);
+		}
+		if (numFree == 0) {
+			remove(tail);
+		}
+		int e = freeEntries[--numFree];
+		gallery[e].trackingId = a.trackingId;
+		gallery[e].person = a.person;
+		gallery[e].lostTime = frameTime;
+		pushFront(e);
+		if (a.person.uid >= 0) uidEntry[a.person.uid] = e;
+	}
+
+	// forget old ones, tail is the oldest
+	while (tail >= 0 && frameTime > gallery[tail].lostTime + maxGap) {
+		remove(tail);
+	}
+}
+
+void ofxHvcP2ReIdentifier::clear() {
+	for (auto &a : active) a.used = false;
+	head = tail = -1;
+	numFree = maxGallery;
+	for (int i = 0; i < maxGallery; ++i) freeEntries[i] = maxGallery - 1 - i;
+	for (auto &u : uidEntry) u = -1;
+	merges.clear();
+}
+
+int ofxHvcP2ReIdentifier::getIdentity(int trackingId) const {
+	for (auto &a : active) {
+		if (a.used && a.trackingId == trackingId) return a.person.identity;
+	}
+	return -1;
+}
+
+int ofxHvcP2ReIdentifier::findEntry(const Person &person) const {
+	if (person.uid >= 0 && uidEntry[person.uid] >= 0) {
+		return uidEntry[person.uid];
+	}
+
+	// nearest lost track in the gate, gallery is at most maxGallery
+	int best = -1;
+	float bestCost = 0;
+	for (int e = head; e >= 0; e = gallery[e].next) {
+		auto &g = gallery[e].person;
+		if (g.uid >= 0 && person.uid >= 0) continue;
+		if (g.gender >= 0 && person.gender >= 0 && g.gender != person.gender) continue;
+
+		float dx = person.x - g.x;
+		float dy = person.y - g.y;
+		float scale = MAX(MAX(person.size, g.size), 1);
+		float distance = sqrtf(dx * dx + dy * dy) / scale;
+		float sizeRatio = (float)MAX(person.size, g.size) / MAX(MIN(person.size, g.size), 1);
+		if (distance > positionGate || sizeRatio > 2) continue;
+
+		float cost = distance / positionGate + (sizeRatio - 1);
+		if (g.age >= 0 && person.age >= 0) cost += fabsf((float)(g.age - person.age)) / 20;
+		if (best < 0 || cost < bestCost) {
+			best = e;
+			bestCost = cost;
+		}
+	}
+	return best;
+}
+
+void ofxHvcP2ReIdentifier::merge(Active &a, int entry) {
+	auto &g = gallery[entry].person;
+
+	Merge m;
+	m.trackingId = a.trackingId;
+	m.identity = g.identity;
+	m.uid = (a.person.uid >= 0 && g.uid == a.person.uid) ? a.person.uid : -1;
+	m.gap = frameTime - gallery[entry].lostTime;
+	merges.push_back(m);
+
+	a.person.identity = g.identity;
+	if (a.person.age < 0) a.person.age = g.age;
+	if (a.person.gender < 0) a.person.gender = g.gender;
+	remove(entry);
+}
+
+void ofxHvcP2ReIdentifier::pushFront(int e) {
+	gallery[e].prev = -1;
+	gallery[e].next = head;
+	if (head >= 0) gallery[head].prev = e;
+	head = e;
+	if (tail < 0) tail = e;
+}
+
+void ofxHvcP2ReIdentifier::remove(int e) {
+	auto &g = gallery[e];
+	if (g.prev >= 0) gallery[g.prev].next = g.next;
+	else head = g.next;
+	if (g.next >= 0) gallery[g.next].prev = g.prev;
+	else tail = g.prev;
+	if (g.person.uid >= 0 && uidEntry[g.person.uid] == e) uidEntry[g.person.uid] = -1;
+	freeEntries[numFree++] = e;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "ofMain.h"
+
+// Join a new STB track to a recently lost one of the same person.
+// Lost tracks are kept in a fixed size gallery ordered by lost time (LRU).
+// A new track matches by recognition UID when it is known,
+// otherwise by position, size, age and gender near where the track was lost.
+// Identity of a person is the tracking ID of its first track.
+class ofxHvcP2ReIdentifier {
+public:
+	ofxHvcP2ReIdentifier();
+
+	static const int maxTracks = 35;
+	static const int maxGallery = 64;
+	static const int maxUid = 100; // album size of HVC-P2
+
+	struct Merge {
+		int trackingId = -1; // new track
+		int identity = -1;   // joined identity
+		int uid = -1;        // recognition UID if matched by UID
+		uint64_t gap = 0;    // millis since the identity was lost
+	};
+
+	// lost tracks older than this are forgotten (millis)
+	void setMaxGap(uint64_t millis);
+	// max distance from the lost position, as ratio of face size
+	void setPositionGate(float ratio);
+
+	// time is elapsed millis
+	void beginFrame(uint64_t time);
+	// uid, age and gender are -1 if unknown (gender 0: female, 1: male). return identity
+	int addFace(int trackingId, int uid, int x, int y, int size, int age, int gender);
+	// tracks which are not added in the frame are moved to the gallery
+	void endFrame();
+	void clear();
+
+	// trackingId itself if not merged, -1 if not tracked
+	int getIdentity(int trackingId) const;
+	// merges in the last frame
+	const vector<Merge> &getMerges() const { return merges; }
+
+private:
+	struct Person {
+		int identity = -1;
+		int uid = -1;
+		int x = 0, y = 0, size = 0;
+		int age = -1, gender = -1;
+	};
+	struct Active {
+		bool used = false;
+		bool seen = false;
+		int trackingId = -1;
+		Person person;
+	};
+	struct Entry {
+		int trackingId = -1;
+		Person person;
+		uint64_t lostTime = 0;
+		int prev = -1, next = -1;
+	};
+
+	int findEntry(const Person &person) const;
+	void merge(Active &active, int entry);
+	void pushFront(int entry);
+	void remove(int entry);
+
+	Active active[maxTracks];
+	Entry gallery[maxGallery];
+	int head, tail; // head is the latest lost
+	int freeEntries[maxGallery];
+	int numFree;
+	int uidEntry[maxUid];
+	vector<Merge> merges;
+
+	uint64_t maxGap;
+	float positionGate;
+	uint64_t frameTime;
+};
@@ -0,0 +1,433 @@
+#include "ofxHvcP2Rules.h"
+
+// element flags, a metric counts elements which have all of its flags
+static const uint32_t newFlag = 1;
+static const uint32_t withoutFaceFlag = 2;
+static const uint32_t recognizedFlag = 4;
+static const uint32_t unrecognizedFlag = 8;
+
+// time to remember a tracking ID which is not detected, for "new" (millis)
+static const uint64_t seenTime = 1000;
+
+ofxHvcP2Rules::ofxHvcP2Rules() {
+	zones = NULL;
+	numNewMetrics = 0;
+	updateTime = 0;
+}
+
+int ofxHvcP2Rules::addRule(const string &name, const string &text) {
+	Rule rule;
+	string error;
+	if (!parse(text, rule, error)) {
+		ofLogError("ofxHvcP2Rules") << name << " : " << error << " (" << text << ")";
+		return -1;
+	}
+	rule.name = name;
+	return addRule(rule);
+}
+
+int ofxHvcP2Rules::addRule(const Rule &rule) {
+	if (rule.zone >= ofxHvcP2Counter::maxZones || rule.value < 0) {
+		ofLogError("ofxHvcP2Rules") << rule.name << " : invalid zone or value";
+		return -1;
+	}
+	Compiled c;
+	c.rule = rule;
+	c.state = Idle;
+	c.since = 0;
+	c.cooldownUntil = 0;
+	c.value = 0;
+
+	// share the metric and the window with other rules
+	uint32_t flags = getFlags(rule);
+	c.metric = -1;
+	for (int i = 0; i < (int)metrics.size(); ++i) {
+		auto &m = metrics[i];
+		if (m.subject == rule.subject && m.zone == rule.zone && m.flags == flags) c.metric = i;
+	}
+	if (c.metric < 0) {
+		Metric m;
+		m.subject = rule.subject;
+		m.zone = rule.zone;
+		m.flags = flags;
+		m.newIndex = -1;
+		m.value = 0;
+		if (rule.isNew) {
+			// tracks already seen do not count as new for the added rule
+			m.newIndex = numNewMetrics++;
+			for (auto &tracks : seen) {
+				for (auto &t : tracks) {
+					t.matched.resize((numNewMetrics + 63) / 64, 0);
+					if (t.trackingId >= 0) t.matched[m.newIndex / 64] |= 1ull << (m.newIndex % 64);
+				}
+			}
+		}
+		c.metric = metrics.size();
+		metrics.push_back(m);
+	}
+
+	c.window = -1;
+	if (rule.window > 0) {
+		for (int i = 0; i < (int)windows.size(); ++i) {
+			if (windows[i].metric == c.metric && windows[i].length == rule.window) c.window = i;
+		}
+		if (c.window < 0) {
+			Window w;
+			w.metric = c.metric;
+			w.length = rule.window;
+			w.bucketLength = MAX(rule.window / windowBuckets, (uint64_t)1);
+			w.buckets.assign(windowBuckets, 0);
+			w.currentBucket = 0;
+			w.started = false;
+			w.sum = 0;
+			c.window = windows.size();
+			windows.push_back(w);
+		}
+	}
+
+	rules.push_back(c);
+	return rules.size() - 1;
+}
+
+// split to words, numbers with units and operators. false if there is an unknown character
+static bool tokenize(const string &text, vector<string> &tokens, string &error) {
+	tokens.clear();
+	string token;
+	bool op = false;
+	for (char ch : text) {
+		// only ASCII, ctype functions are undefined for negative char
+		unsigned char c = ch;
+		if (c >= 0x80) {
+			error = "unknown character";
+			return false;
+		}
+		c = tolower(c);
+		bool isOp = c == '<' || c == '>' || c == '=' || c == '!';
+		bool isWord = isalnum(c) || c == '.';
+		if (!isOp && !isWord && !isspace(c)) {
+			error = string("unknown character ") + (char)c;
+			return false;
+		}
+		if (!token.empty() && (!(isOp || isWord) || isOp != op)) {
+			tokens.push_back(token);
+			token.clear();
+		}
+		if (isOp || isWord) {
+			token += c;
+			op = isOp;
+		}
+	}
+	if (!token.empty()) tokens.push_back(token);
+	return true;
+}
+
+static bool parseNumber(const string &token, int &out) {
+	// no sign (the tokenizer has no '-'), and small enough for int
+	if (token.empty() || token.size() > 9) return false;
+	for (size_t i = 0; i < token.size(); ++i) {
+		if (!isdigit((unsigned char)token[i])) return false;
+	}
+	out = atoi(token.c_str());
+	return true;
+}
+
+// "10s", "10 s", "500ms", "2m". no unit is millis
+static bool parseDuration(const vector<string> &tokens, size_t &i, uint64_t &out) {
+	if (i >= tokens.size()) return false;
+	const string &token = tokens[i++];
+	size_t digits = 0;
+	while (digits < token.size() && (isdigit((unsigned char)token[digits]) || token[digits] == '.')) ++digits;
+	if (digits == 0) return false;
+	float value = atof(token.substr(0, digits).c_str());
+	string unit = token.substr(digits);
+	if (unit.empty() && i < tokens.size() && !isdigit((unsigned char)tokens[i][0])) {
+		const string &next = tokens[i];
+		if (next == "ms" || next == "s" || next == "sec" || next == "m" || next == "min") unit = tokens[i++];
+	}
+	if (unit == "" || unit == "ms") out = value;
+	else if (unit == "s" || unit == "sec") out = value * 1000;
+	else if (unit == "m" || unit == "min") out = value * 60000;
+	else return false;
+	return true;
+}
+
+bool ofxHvcP2Rules::parse(const string &text, Rule &out, string &error) {
+	out = Rule();
+	vector<string> tokens;
+	if (!tokenize(text, tokens, error)) return false;
+	size_t i = 0;
+	auto next = [&](const string &word) {
+		if (i < tokens.size() && tokens[i] == word) {
+			++i;
+			return true;
+		}
+		return false;
+	};
+
+	out.isNew = next("new");
+	if (next("recognized")) out.recognized = true;
+	else if (next("unrecognized")) out.unrecognized = true;
+
+	if (next("faces") || next("face")) out.subject = Faces;
+	else if (next("bodies") || next("body")) out.subject = Bodies;
+	else if (next("hands") || next("hand")) out.subject = Hands;
+	else {
+		error = "faces, bodies or hands is expected";
+		return false;
+	}
+	if ((out.recognized || out.unrecognized) && out.subject != Faces) {
+		error = "recognition is only for faces";
+		return false;
+	}
+
+	if (next("in")) {
+		if (!next("zone") || i >= tokens.size() || !parseNumber(tokens[i++], out.zone)) {
+			error = "zone number is expected";
+			return false;
+		}
+		if (out.zone >= ofxHvcP2Counter::maxZones) {
+			error = "zone has to be less than " + ofToString(ofxHvcP2Counter::maxZones);
+			return false;
+		}
+	}
+	if (next("without")) {
+		if (!(next("face") || next("faces")) || out.subject != Bodies) {
+			error = "only bodies can be without face";
+			return false;
+		}
+		out.withoutFace = true;
+	}
+
+	if (i >= tokens.size()) {
+		error = "comparison is expected";
+		return false;
+	}
+	const string &op = tokens[i++];
+	if (op == ">") out.compare = Greater;
+	else if (op == ">=") out.compare = GreaterEqual;
+	else if (op == "<") out.compare = Less;
+	else if (op == "<=") out.compare = LessEqual;
+	else if (op == "==" || op == "=") out.compare = Equal;
+	else if (op == "!=") out.compare = NotEqual;
+	else {
+		error = "unknown comparison " + op;
+		return false;
+	}
+	if (i >= tokens.size() || !parseNumber(tokens[i++], out.value)) {
+		error = "number is expected";
+		return false;
+	}
+
+	while (i < tokens.size()) {
+		string word = tokens[i++];
+		uint64_t *target = NULL;
+		if (word == "for") target = &out.forTime;
+		else if (word == "within") target = &out.window;
+		else if (word == "hold") target = &out.holdTime;
+		else if (word == "cooldown") target = &out.cooldown;
+		if (target == NULL || !parseDuration(tokens, i, *target)) {
+			error = "unknown clause " + word;
+			return false;
+		}
+	}
+	return true;
+}
+
+void ofxHvcP2Rules::clearRules() {
+	rules.clear();
+	metrics.clear();
+	windows.clear();
+	numNewMetrics = 0;
+	for (auto &tracks : seen) {
+		for (auto &t : tracks) t.matched.clear();
+	}
+}
+
+void ofxHvcP2Rules::setZones(const ofxHvcP2Counter *_zones) {
+	zones = _zones;
+}
+
+void ofxHvcP2Rules::update(const ofxHvcP2::Faces &faces, const ofxHvcP2::Bodies &bodies, const ofxHvcP2::Hands &hands, uint64_t frameTime) {
+	uint64_t startTime = ofGetElapsedTimeMicros();
+	events.clear();
+
+	// count each metric once
+	for (auto &m : metrics) m.value = 0;
+	for (auto &f : faces) {
+		Seen *track = markSeen(seen[Faces], f.trackingId, frameTime);
+		countMetrics(Faces, getFaceFlags(f), track, f.position.x, f.position.y);
+	}
+	for (auto &b : bodies) {
+		Seen *track = markSeen(seen[Bodies], b.trackingId, frameTime);
+		countMetrics(Bodies, getBodyFlags(b, faces), track, b.position.x, b.position.y);
+	}
+	for (auto &h : hands) {
+		Seen *track = markSeen(seen[Hands], h.trackingId, frameTime);
+		countMetrics(Hands, 0, track, h.position.x, h.position.y);
+	}
+	for (auto &w : windows) updateWindow(w, frameTime);
+	for (auto &s : seen) {
+		for (auto &t : s) {
+			if (t.trackingId >= 0 && t.time + seenTime < frameTime) t.trackingId = -1;
+		}
+	}
+
+	// state machine of each rule
+	for (int i = 0; i < (int)rules.size(); ++i) {
+		auto &c = rules[i];
+		c.value = c.window >= 0 ? windows[c.window].sum : metrics[c.metric].value;
+		bool condition = check(c.rule.compare, c.value, c.rule.value);
+
+		switch (c.state) {
+		case Idle:
+			if (condition) setState(c, Pending, frameTime, i);
+			break;
+		case Pending:
+			if (!condition) setState(c, Idle, frameTime, i);
+			break;
+		case Active:
+			if (!condition) setState(c, Releasing, frameTime, i);
+			break;
+		case Releasing:
+			if (condition) c.state = Active;
+			else if (frameTime - c.since >= c.rule.holdTime) setState(c, Idle, frameTime, i);
+			break;
+		}
+		if (c.state == Pending && frameTime - c.since >= c.rule.forTime && frameTime >= c.cooldownUntil) {
+			setState(c, Active, frameTime, i);
+		}
+		if (c.state == Releasing && c.rule.holdTime == 0) setState(c, Idle, frameTime, i);
+	}
+	updateTime = ofGetElapsedTimeMicros() - startTime;
+
+	for (auto &e : events) {
+		ofNotifyEvent(ruleEvent, e, this);
+	}
+}
+
+bool ofxHvcP2Rules::isActive(int rule) const {
+	if (rule < 0 || rule >= (int)rules.size()) return false;
+	return rules[rule].state == Active || rules[rule].state == Releasing;
+}
+
+int ofxHvcP2Rules::getValue(int rule) const {
+	if (rule < 0 || rule >= (int)rules.size()) return 0;
+	return rules[rule].value;
+}
+
+uint32_t ofxHvcP2Rules::getFlags(const Rule &rule) {
+	uint32_t flags = 0;
+	if (rule.isNew) flags |= newFlag;
+	if (rule.withoutFace) flags |= withoutFaceFlag;
+	if (rule.recognized) flags |= recognizedFlag;
+	if (rule.unrecognized) flags |= unrecognizedFlag;
+	return flags;
+}
+
+uint32_t ofxHvcP2Rules::getFaceFlags(const ofxHvcP2::Face &f) {
+	uint32_t flags = 0;
+	if (f.recognitionUid >= 0) flags |= recognizedFlag;
+	else if (f.recognitionStbState == ofxHvcP2::Complete) flags |= unrecognizedFlag;
+	return flags;
+}
+
+uint32_t ofxHvcP2Rules::getBodyFlags(const ofxHvcP2::Body &b, const ofxHvcP2::Faces &faces) {
+	uint32_t flags = 0;
+
+	// a face center in the body rect
+	int half = b.size / 2;
+	bool hasFace = false;
+	for (auto &f : faces) {
+		if (abs(f.position.x - b.position.x) <= half && abs(f.position.y - b.position.y) <= half) {
+			hasFace = true;
+			break;
+		}
+	}
+	if (!hasFace) flags |= withoutFaceFlag;
+	return flags;
+}
+
+ofxHvcP2Rules::Seen *ofxHvcP2Rules::markSeen(Seen *s, int trackingId, uint64_t frameTime) {
+	if (trackingId < 0) return NULL;
+	Seen *free = NULL;
+	for (int i = 0; i < maxSeen; ++i) {
+		if (s[i].trackingId == trackingId) {
+			s[i].time = frameTime;
+			return &s[i];
+		}
+		if (s[i].trackingId < 0 && free == NULL) free = &s[i];
+	}
+	if (free != NULL) {
+		free->trackingId = trackingId;
+		free->time = frameTime;
+		free->matched.assign((numNewMetrics + 63) / 64, 0);
+	}
+	return free;
+}
+
+void ofxHvcP2Rules::countMetrics(Subject subject, uint32_t flags, Seen *track, int x, int y) {
+	uint32_t zoneMask = zones != NULL ? zones->getZoneMask(x, y) : 0;
+	for (auto &m : metrics) {
+		uint32_t filters = m.flags & ~newFlag;
+		if (m.subject != subject || (flags & filters) != filters) continue;
+		if (m.zone >= 0 && !(m.zone < 32 && (zoneMask & (1u << m.zone)))) continue;
+		// "new" counts a track once, in the first frame it matches the other filters
+		if (m.newIndex >= 0) {
+			if (track == NULL) continue;
+			uint64_t &word = track->matched[m.newIndex / 64];
+			uint64_t bit = 1ull << (m.newIndex % 64);
+			if (word & bit) continue;
+			word |= bit;
+		}
+		++m.value;
+	}
+}
+
+void ofxHvcP2Rules::updateWindow(Window &w, uint64_t frameTime) {
+	uint64_t bucket = frameTime / w.bucketLength;
+	if (!w.started) {
+		w.currentBucket = bucket;
+		w.started = true;
+	}
+	// buckets which leave the window are subtracted, at most once per bucket
+	uint64_t steps = MIN(bucket - w.currentBucket, (uint64_t)windowBuckets);
+	for (uint64_t i = 1; i <= steps; ++i) {
+		int &old = w.buckets[(w.currentBucket + i) % windowBuckets];
+		w.sum -= old;
+		old = 0;
+	}
+	w.currentBucket = MAX(bucket, w.currentBucket);
+
+	int value = metrics[w.metric].value;
+	w.buckets[w.currentBucket % windowBuckets] += value;
+	w.sum += value;
+}
+
+bool ofxHvcP2Rules::check(Compare compare, int value, int threshold) {
+	switch (compare) {
+	case Greater: return value > threshold;
+	case GreaterEqual: return value >= threshold;
+	case Less: return value < threshold;
+	case LessEqual: return value <= threshold;
+	case Equal: return value == threshold;
+	case NotEqual: return value != threshold;
+	default: return false;
+	}
+}
+
+void ofxHvcP2Rules::setState(Compiled &c, State state, uint64_t frameTime, int index) {
+	bool wasActive = c.state == Active || c.state == Releasing;
+	bool active = state == Active || state == Releasing;
+	if (state != Releasing || c.state != Releasing) c.since = frameTime;
+	c.state = state;
+	if (wasActive == active) return;
+
+	if (active) c.cooldownUntil = frameTime + c.rule.cooldown;
+	Event e;
+	e.rule = index;
+	e.name = c.rule.name;
+	e.active = active;
+	e.time = frameTime;
+	e.value = c.value;
+	events.push_back(e);
+}
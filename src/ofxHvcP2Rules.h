@@ -0,0 +1,141 @@
+#pragma once
+#include "ofxHvcP2.h"
+#include "ofxHvcP2Counter.h"
+
+// Rules over the frame stream, e.g.
+//   "faces > 5 for 10s"
+//   "bodies in zone 0 without face >= 1 for 30s"
+//   "new unrecognized faces >= 1"
+//   "new faces > 20 within 5m cooldown 1m"
+// grammar : [new] [recognized|unrecognized] faces|bodies|hands [in zone N] [without face]
+//           >|>=|<|<=|==|!= number [for T] [within T] [hold T] [cooldown T]   (T is 500ms, 10s, 2m)
+// for : the condition has to be true for T. within : the count is summed over the last T.
+// hold : the rule stays active until the condition is false for T. cooldown : time from firing to firing again.
+// Rules are compiled to shared metrics (each distinct count is made once per frame)
+// and a small state machine per rule, so hundreds of rules cost a few micros per frame.
+class ofxHvcP2Rules {
+public:
+	ofxHvcP2Rules();
+
+	enum Subject {
+		Faces,
+		Bodies,
+		Hands
+	};
+
+	enum Compare {
+		Greater,
+		GreaterEqual,
+		Less,
+		LessEqual,
+		Equal,
+		NotEqual
+	};
+
+	struct Rule {
+		string name;
+		Subject subject = Faces;
+		int zone = -1;             // zone of setZones(), -1 is everywhere
+		bool isNew = false;        // tracks which match the other filters for the first time in the frame
+		bool withoutFace = false;  // bodies without a face in the body
+		bool recognized = false;   // faces with recognition UID
+		bool unrecognized = false; // faces checked as not registered (uid -1, recognition Complete)
+		Compare compare = Greater;
+		int value = 0;
+		uint64_t forTime = 0;  // millis
+		uint64_t window = 0;   // millis, 0 is the count of the frame
+		uint64_t holdTime = 0; // millis
+		uint64_t cooldown = 0; // millis
+	};
+
+	struct Event {
+		int rule = -1;
+		string name;
+		bool active = false; // true when fired, false when released
+		uint64_t time = 0;   // elapsed millis of the frame
+		int value = 0;       // count of the rule
+	};
+
+	// parse and add a rule. return index, -1 if the text has an error (logged)
+	int addRule(const string &name, const string &text);
+	int addRule(const Rule &rule);
+	static bool parse(const string &text, Rule &out, string &error);
+	void clearRules();
+	int getNumRules() const { return rules.size(); }
+
+	// zones for "in zone N", the counter has to live while rules are used
+	void setZones(const ofxHvcP2Counter *zones);
+
+	// frameTime is elapsed millis when the frame was received
+	void update(const ofxHvcP2::Faces &faces, const ofxHvcP2::Bodies &bodies, const ofxHvcP2::Hands &hands, uint64_t frameTime);
+
+	bool isActive(int rule) const;
+	int getValue(int rule) const;
+	// events of the last update
+	const vector<Event> &getEvents() const { return events; }
+	// processing time of the last update (micros)
+	uint64_t getUpdateTime() const { return updateTime; }
+
+	ofEvent<Event> ruleEvent;
+
+private:
+	static const int maxSeen = 64;
+	static const int windowBuckets = 60;
+
+	// a count of the frame, shared by rules with the same filters
+	struct Metric {
+		Subject subject;
+		int zone;
+		uint32_t flags;
+		int newIndex; // bit of Seen::matched, -1 if not "new"
+		int value;
+	};
+	// a count summed over a window in windowBuckets buckets
+	struct Window {
+		int metric;
+		uint64_t length;
+		uint64_t bucketLength;
+		vector<int> buckets;
+		uint64_t currentBucket;
+		bool started;
+		int sum;
+	};
+	enum State {
+		Idle,
+		Pending,
+		Active,
+		Releasing
+	};
+	struct Compiled {
+		Rule rule;
+		int metric;
+		int window; // -1 for the count of the frame
+		State state;
+		uint64_t since;
+		uint64_t cooldownUntil;
+		int value;
+	};
+	struct Seen {
+		int trackingId = -1;
+		uint64_t time = 0;
+		vector<uint64_t> matched; // "new" metrics the track has already counted for
+	};
+
+	static uint32_t getFlags(const Rule &rule);
+	static uint32_t getFaceFlags(const ofxHvcP2::Face &f);
+	static uint32_t getBodyFlags(const ofxHvcP2::Body &b, const ofxHvcP2::Faces &faces);
+	Seen *markSeen(Seen *seen, int trackingId, uint64_t frameTime);
+	void countMetrics(Subject subject, uint32_t flags, Seen *track, int x, int y);
+	void updateWindow(Window &w, uint64_t frameTime);
+	static bool check(Compare compare, int value, int threshold);
+	void setState(Compiled &c, State state, uint64_t frameTime, int index);
+
+	const ofxHvcP2Counter *zones;
+	vector<Metric> metrics;
+	int numNewMetrics;
+	vector<Window> windows;
+	vector<Compiled> rules;
+	Seen seen[3][maxSeen];
+	vector<Event> events;
+	uint64_t updateTime;
+};
@@ -0,0 +1,187 @@
+#include "ofxHvcP2ThumbnailAtlas.h"
+
+// HVC-P2 returns positions in 1600x1200
+const ofxHvcP2ThumbnailAtlas::Transform ofxHvcP2ThumbnailAtlas::transforms[] = {
+	{ 320, 240, 320.0f / 1600.0f }, // QVGA
+	{ 160, 120, 160.0f / 1600.0f }  // QVGA_HALF
+};
+
+ofxHvcP2ThumbnailAtlas::ofxHvcP2ThumbnailAtlas() {
+	image = NULL;
+	imageWidth = imageHeight = 0;
+	transform = NULL;
+	faceWidth = faceHeight = 64;
+	bodyWidth = 48;
+	bodyHeight = 96;
+	numFaceTiles = numBodyTiles = 0;
+	tiles.reserve(maxTilesPerType * 2);
+}
+
+void ofxHvcP2ThumbnailAtlas::setFaceTileSize(int width, int height) {
+	faceWidth = ofClamp(width, 1, maxTileSize);
+	faceHeight = ofClamp(height, 1, maxTileSize);
+}
+
+void ofxHvcP2ThumbnailAtlas::setBodyTileSize(int width, int height) {
+	bodyWidth = ofClamp(width, 1, maxTileSize);
+	bodyHeight = ofClamp(height, 1, maxTileSize);
+}
+
+bool ofxHvcP2ThumbnailAtlas::begin(const unsigned char *_image, int width, int height) {
+	clear();
+
+	transform = NULL;
+	for (auto &t : transforms) {
+		if (t.width == width && t.height == height) {
+			transform = &t;
+			break;
+		}
+	}
+	if (transform == NULL || _image == NULL) return false;
+
+	image = _image;
+	imageWidth = width;
+	imageHeight = height;
+
+	// faces first, then bodies
+	size_t needSize = (size_t)maxTilesPerType * (faceWidth * faceHeight + bodyWidth * bodyHeight);
+	if (buffer.size() != needSize) {
+		allocateBuffer();
+	}
+	return true;
+}
+
+bool ofxHvcP2ThumbnailAtlas::addFace(int index, int trackingId, int x, int y, int size) {
+	return addTile(FaceTile, index, trackingId, x, y, size);
+}
+
+bool ofxHvcP2ThumbnailAtlas::addBody(int index, int trackingId, int x, int y, int size) {
+	return addTile(BodyTile, index, trackingId, x, y, size);
+}
+
+void ofxHvcP2ThumbnailAtlas::clear() {
+	tiles.clear();
+	numFaceTiles = numBodyTiles = 0;
+	image = NULL;
+}
+
+void ofxHvcP2ThumbnailAtlas::copyTiles(ofxHvcP2ThumbnailAtlas &out) const {
+	out.image = NULL;
+	out.imageWidth = imageWidth;
+	out.imageHeight = imageHeight;
+	out.transform = transform;
+	out.faceWidth = faceWidth;
+	out.faceHeight = faceHeight;
+	out.bodyWidth = bodyWidth;
+	out.bodyHeight = bodyHeight;
+	out.numFaceTiles = numFaceTiles;
+	out.numBodyTiles = numBodyTiles;
+	out.tiles = tiles;
+
+	size_t size = 0;
+	for (auto &t : tiles) size += t.width * t.height;
+	out.buffer.resize(size);
+	size_t offset = 0;
+	for (auto &t : out.tiles) {
+		memcpy(out.buffer.data() + offset, buffer.data() + t.offset, t.width * t.height);
+		t.offset = offset;
+		offset += t.width * t.height;
+	}
+}
+
+const unsigned char * ofxHvcP2ThumbnailAtlas::getTileData(size_t tileIndex) const {
+	return buffer.data() + tiles[tileIndex].offset;
+}
+
+void ofxHvcP2ThumbnailAtlas::getTilePixels(size_t tileIndex, ofPixels & out) const {
+	auto &t = tiles[tileIndex];
+	out.setFromPixels(getTileData(tileIndex), t.width, t.height, OF_IMAGE_GRAYSCALE);
+}
+
+int ofxHvcP2ThumbnailAtlas::findTile(TileType type, int trackingId) const {
+	for (int i = 0; i < (int)tiles.size(); ++i) {
+		if (tiles[i].type == type && tiles[i].trackingId == trackingId) return i;
+	}
+	return -1;
+}
+
+void ofxHvcP2ThumbnailAtlas::allocateBuffer() {
+	size_t size = (size_t)maxTilesPerType * (faceWidth * faceHeight + bodyWidth * bodyHeight);
+	buffer.assign(size, 0);
+}
+
+bool ofxHvcP2ThumbnailAtlas::addTile(TileType type, int index, int trackingId, int x, int y, int size) {
+	if (image == NULL || size <= 0) return false;
+
+	Tile tile;
+	tile.type = type;
+	tile.index = index;
+	tile.trackingId = trackingId;
+	if (type == FaceTile) {
+		if (numFaceTiles >= maxTilesPerType) return false;
+		tile.width = faceWidth;
+		tile.height = faceHeight;
+		tile.offset = (size_t)numFaceTiles * faceWidth * faceHeight;
+		++numFaceTiles;
+	}
+	else {
+		if (numBodyTiles >= maxTilesPerType) return false;
+		tile.width = bodyWidth;
+		tile.height = bodyHeight;
+		tile.offset = (size_t)maxTilesPerType * faceWidth * faceHeight + (size_t)numBodyTiles * bodyWidth * bodyHeight;
+		++numBodyTiles;
+	}
+
+	// detection is square. expand short side to keep tile aspect.
+	float side = size * transform->scale;
+	float aspect = (float)tile.width / tile.height;
+	float w = aspect >= 1 ? side * aspect : side;
+	float h = aspect >= 1 ? side : side / aspect;
+	tile.source = ofRectangle(x * transform->scale - w / 2, y * transform->scale - h / 2, w, h);
+
+	resample(tile, buffer.data() + tile.offset);
+	tiles.push_back(tile);
+	return true;
+}
+
+// bilinear resampling in 8bit fixed point.
+// vertical blend is done for the whole source span first (simple loop that compiler vectorizes),
+// then each output pixel is blended horizontally with precomputed index and weight.
+void ofxHvcP2ThumbnailAtlas::resample(const Tile &tile, unsigned char *dst) {
+	float stepX = tile.source.width / tile.width;
+	float stepY = tile.source.height / tile.height;
+
+	// column table (outside of image is clamped to edge)
+	int minX = imageWidth, maxX = 0;
+	for (int i = 0; i < tile.width; ++i) {
+		float sx = ofClamp(tile.source.x + (i + 0.5f) * stepX - 0.5f, 0, imageWidth - 1);
+		int x0 = MIN((int)sx, imageWidth - 2);
+		xIndex[i] = x0;
+		xWeight[i] = (int)((sx - x0) * 256);
+		minX = MIN(minX, x0);
+		maxX = MAX(maxX, x0);
+	}
+	for (int i = 0; i < tile.width; ++i) {
+		xIndex[i] -= minX;
+	}
+	int span = maxX - minX + 2;
+
+	for (int j = 0; j < tile.height; ++j) {
+		float sy = ofClamp(tile.source.y + (j + 0.5f) * stepY - 0.5f, 0, imageHeight - 1);
+		int y0 = MIN((int)sy, imageHeight - 2);
+		int wy = (int)((sy - y0) * 256);
+
+		const unsigned char *row0 = image + y0 * imageWidth + minX;
+		const unsigned char *row1 = row0 + imageWidth;
+		for (int x = 0; x < span; ++x) {
+			blendRow[x] = (unsigned short)(row0[x] * (256 - wy) + row1[x] * wy);
+		}
+
+		unsigned char *out = dst + j * tile.width;
+		for (int i = 0; i < tile.width; ++i) {
+			int a = blendRow[xIndex[i]];
+			int b = blendRow[xIndex[i] + 1];
+			out[i] = (unsigned char)((a * (256 - xWeight[i]) + b * xWeight[i] + 32768) >> 16);
+		}
+	}
+}
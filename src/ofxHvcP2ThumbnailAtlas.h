@@ -0,0 +1,85 @@
+#pragma once
+#include "ofMain.h"
+
+// Fixed size face / body thumbnails cut from the captured image.
+// All tiles of one frame are stored in one contiguous buffer,
+// which is allocated once for the maximum number of detections.
+class ofxHvcP2ThumbnailAtlas {
+public:
+	ofxHvcP2ThumbnailAtlas();
+
+	enum TileType {
+		FaceTile,
+		BodyTile
+	};
+
+	struct Tile {
+		TileType type;
+		int index;          // index in Faces or Bodies
+		int trackingId;
+		int width, height;
+		size_t offset;      // byte offset in the atlas buffer
+		ofRectangle source; // cropped region in image pixels
+	};
+
+	static const int maxTilesPerType = 35;
+	static const int maxTileSize = 256;
+
+	// tile size is applied from the next begin()
+	void setFaceTileSize(int width, int height);
+	void setBodyTileSize(int width, int height);
+	int getFaceTileWidth() const { return faceWidth; }
+	int getFaceTileHeight() const { return faceHeight; }
+	int getBodyTileWidth() const { return bodyWidth; }
+	int getBodyTileHeight() const { return bodyHeight; }
+
+	// start a new frame with grayscale image (QVGA or QVGA_HALF)
+	// return false if the image size is not supported
+	bool begin(const unsigned char *image, int width, int height);
+
+	// position and size are HVC coordinates (1600x1200)
+	bool addFace(int index, int trackingId, int x, int y, int size);
+	bool addBody(int index, int trackingId, int x, int y, int size);
+
+	void clear();
+
+	// copy the tiles of the frame, packed without unused slots. out does not refer to the image
+	void copyTiles(ofxHvcP2ThumbnailAtlas &out) const;
+
+	size_t getNumTiles() const { return tiles.size(); }
+	const Tile &getTile(size_t tileIndex) const { return tiles[tileIndex]; }
+	const unsigned char *getTileData(size_t tileIndex) const;
+	void getTilePixels(size_t tileIndex, ofPixels &out) const;
+	const vector<unsigned char> &getBuffer() const { return buffer; }
+
+	// search tile, return -1 if not found
+	int findTile(TileType type, int trackingId) const;
+
+private:
+	// HVC coordinates to image coordinates
+	struct Transform {
+		int width, height;
+		float scale;
+	};
+	static const Transform transforms[];
+
+	bool addTile(TileType type, int index, int trackingId, int x, int y, int size);
+	void resample(const Tile &tile, unsigned char *dst);
+	void allocateBuffer();
+
+	const unsigned char *image;
+	int imageWidth, imageHeight;
+	const Transform *transform;
+
+	int faceWidth, faceHeight;
+	int bodyWidth, bodyHeight;
+	int numFaceTiles, numBodyTiles;
+
+	vector<Tile> tiles;
+	vector<unsigned char> buffer;
+
+	// resampler work area
+	int xIndex[maxTileSize];
+	int xWeight[maxTileSize];
+	unsigned short blendRow[320 + 1];
+};
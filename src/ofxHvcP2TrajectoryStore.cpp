@@ -0,0 +1,235 @@
+#include "ofxHvcP2TrajectoryStore.h"
+
+ofxHvcP2TrajectoryStore::ofxHvcP2TrajectoryStore(int _capacity) : capacity(2) {
+	for (auto &t : tracks) {
+		t.trackingId.store(-1);
+		t.sequence.store(0);
+	}
+	frameTime = 0;
+
+	// buffers are never reallocated, readers may hold them at any time
+	int total = maxTracks * maxCapacity;
+	times.assign(total, 0);
+	xs.assign(total, 0);
+	ys.assign(total, 0);
+	sizes.assign(total, 0);
+	pitches.assign(total, 0);
+	rolls.assign(total, 0);
+	yaws.assign(total, 0);
+	gazeLRs.assign(total, 0);
+	gazeUDs.assign(total, 0);
+	setCapacity(_capacity);
+}
+
+void ofxHvcP2TrajectoryStore::setCapacity(int _capacity) {
+	// all tracks are marked as writing, so no reader mixes two capacities
+	for (auto &t : tracks) {
+		t.sequence.store(t.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+	std::atomic_thread_fence(std::memory_order_release);
+	capacity.store(ofClamp(_capacity, 2, maxCapacity), std::memory_order_relaxed);
+	for (auto &t : tracks) {
+		t.trackingId.store(-1, std::memory_order_relaxed);
+		t.active = false;
+		t.seen = false;
+		t.head = 0;
+		t.count = 0;
+		t.firstTime = 0;
+		t.pathLength = 0;
+		t.sequence.store(t.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+}
+
+void ofxHvcP2TrajectoryStore::beginFrame(uint64_t time) {
+	frameTime = time;
+	for (auto &t : tracks) t.seen = false;
+}
+
+void ofxHvcP2TrajectoryStore::add(int trackingId, const Observation &observation) {
+	if (trackingId < 0) return;
+
+	int c = capacity.load(std::memory_order_relaxed);
+	int slot = findSlot(trackingId);
+	if (slot < 0) {
+		// free slot, or the slot lost longest ago
+		uint64_t oldest = 0;
+		for (int i = 0; i < maxTracks; ++i) {
+			auto &t = tracks[i];
+			if (t.active) continue;
+			if (t.trackingId.load(std::memory_order_relaxed) < 0) {
+				slot = i;
+				break;
+			}
+			uint64_t lastTime = times[i * maxCapacity + (t.head + c - 1) % c];
+			if (slot < 0 || lastTime < oldest) {
+				slot = i;
+				oldest = lastTime;
+			}
+		}
+		if (slot < 0) return;
+
+		auto &t = tracks[slot];
+		unsigned int s = t.sequence.load(std::memory_order_relaxed);
+		t.sequence.store(s + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		t.trackingId.store(trackingId, std::memory_order_relaxed);
+		t.head = 0;
+		t.count = 0;
+		t.firstTime = observation.time;
+		t.pathLength = 0;
+		t.sequence.store(s + 2, std::memory_order_release);
+	}
+
+	tracks[slot].active = true;
+	tracks[slot].seen = true;
+	write(slot, observation);
+}
+
+void ofxHvcP2TrajectoryStore::endFrame() {
+	for (auto &t : tracks) {
+		if (t.active && !t.seen) t.active = false;
+	}
+}
+
+void ofxHvcP2TrajectoryStore::clear() {
+	for (auto &t : tracks) {
+		unsigned int s = t.sequence.load(std::memory_order_relaxed);
+		t.sequence.store(s + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		t.trackingId.store(-1, std::memory_order_relaxed);
+		t.active = false;
+		t.seen = false;
+		t.head = 0;
+		t.count = 0;
+		t.firstTime = 0;
+		t.pathLength = 0;
+		t.sequence.store(s + 2, std::memory_order_release);
+	}
+}
+
+int ofxHvcP2TrajectoryStore::findSlot(int trackingId) const {
+	for (int i = 0; i < maxTracks; ++i) {
+		if (tracks[i].trackingId.load(std::memory_order_relaxed) == trackingId) return i;
+	}
+	return -1;
+}
+
+void ofxHvcP2TrajectoryStore::write(int slot, const Observation &o) {
+	auto &t = tracks[slot];
+	unsigned int s = t.sequence.load(std::memory_order_relaxed);
+	t.sequence.store(s + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	int c = capacity.load(std::memory_order_relaxed);
+	int base = slot * maxCapacity;
+	if (t.count > 0) {
+		int last = base + (t.head + c - 1) % c;
+		float dx = o.x - xs[last];
+		float dy = o.y - ys[last];
+		t.pathLength += sqrtf(dx * dx + dy * dy);
+	}
+	int i = base + t.head;
+	times[i] = o.time;
+	xs[i] = o.x;
+	ys[i] = o.y;
+	sizes[i] = o.size;
+	pitches[i] = o.pitch;
+	rolls[i] = o.roll;
+	yaws[i] = o.yaw;
+	gazeLRs[i] = o.gazeLR;
+	gazeUDs[i] = o.gazeUD;
+	t.head = (t.head + 1) % c;
+	t.count = MIN(t.count + 1, c);
+
+	t.sequence.store(s + 2, std::memory_order_release);
+}
+
+bool ofxHvcP2TrajectoryStore::isActive(int trackingId) const {
+	bool active = false;
+	bool found = read(trackingId, [&](int, int, const Track &t) {
+		active = t.active;
+	});
+	return found && active;
+}
+
+bool ofxHvcP2TrajectoryStore::getLatest(int trackingId, Observation &out) const {
+	return read(trackingId, [&](int base, int c, const Track &t) {
+		int i = base + (t.head + c - 1) % c;
+		out.time = times[i];
+		out.x = xs[i];
+		out.y = ys[i];
+		out.size = sizes[i];
+		out.pitch = pitches[i];
+		out.roll = rolls[i];
+		out.yaw = yaws[i];
+		out.gazeLR = gazeLRs[i];
+		out.gazeUD = gazeUDs[i];
+	});
+}
+
+bool ofxHvcP2TrajectoryStore::getVelocity(int trackingId, uint64_t window, ofVec2f &out) const {
+	return read(trackingId, [&](int base, int c, const Track &t) {
+		out.set(0, 0);
+		if (t.count < 2) return;
+
+		// oldest observation inside the window
+		int latest = base + (t.head + c - 1) % c;
+		int first = latest;
+		int count = MIN(t.count, c);
+		for (int n = 1; n < count; ++n) {
+			int i = base + (t.head + c - 1 - n) % c;
+			if (times[latest] - times[i] > window) break;
+			first = i;
+		}
+		if (first == latest || times[latest] == times[first]) return;
+
+		float dt = (times[latest] - times[first]) / 1000.0f;
+		out.set((xs[latest] - xs[first]) / dt, (ys[latest] - ys[first]) / dt);
+	});
+}
+
+bool ofxHvcP2TrajectoryStore::getPathLength(int trackingId, float &out) const {
+	return read(trackingId, [&](int, int, const Track &t) {
+		out = t.pathLength;
+	});
+}
+
+bool ofxHvcP2TrajectoryStore::getFirstTime(int trackingId, uint64_t &out) const {
+	return read(trackingId, [&](int, int, const Track &t) {
+		out = t.firstTime;
+	});
+}
+
+int ofxHvcP2TrajectoryStore::getHistory(int trackingId, Observation *out, int maxCount) const {
+	int count = 0;
+	bool found = read(trackingId, [&](int base, int c, const Track &t) {
+		count = MIN(MIN(t.count, c), maxCount);
+		int start = t.head + c - count;
+		for (int n = 0; n < count; ++n) {
+			int i = base + (start + n) % c;
+			auto &o = out[n];
+			o.time = times[i];
+			o.x = xs[i];
+			o.y = ys[i];
+			o.size = sizes[i];
+			o.pitch = pitches[i];
+			o.roll = rolls[i];
+			o.yaw = yaws[i];
+			o.gazeLR = gazeLRs[i];
+			o.gazeUD = gazeUDs[i];
+		}
+	});
+	return found ? count : -1;
+}
+
+int ofxHvcP2TrajectoryStore::getTrackingIds(int *out, int maxCount, bool activeOnly) const {
+	int count = 0;
+	for (auto &t : tracks) {
+		if (count >= maxCount) break;
+		int id = t.trackingId.load(std::memory_order_relaxed);
+		if (id < 0) continue;
+		if (activeOnly && !isActive(id)) continue;
+		out[count++] = id;
+	}
+	return count;
+}
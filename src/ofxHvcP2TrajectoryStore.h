@@ -0,0 +1,92 @@
+#pragma once
+#include "ofMain.h"
+#include <atomic>
+
+// Last N observations of each face track, in ring buffers per field (SoA).
+// Memory is allocated once for maxTracks x maxCapacity. One thread writes, and any thread
+// can query without lock or allocation (each track is guarded by a sequence
+// counter, and a reader retries while the writer updates the same track).
+class ofxHvcP2TrajectoryStore {
+public:
+	ofxHvcP2TrajectoryStore(int capacity = 64);
+
+	static const int maxTracks = 35;
+	static const int maxCapacity = 128;
+
+	struct Observation {
+		uint64_t time = 0; // elapsed millis
+		float x = 0, y = 0, size = 0;
+		float pitch = 0, roll = 0, yaw = 0;
+		float gazeLR = 0, gazeUD = 0;
+	};
+
+	// observations per track (2 - maxCapacity). call from the writer thread, stored tracks are cleared
+	void setCapacity(int capacity);
+	int getCapacity() const { return capacity.load(std::memory_order_relaxed); }
+
+	// writer
+	void beginFrame(uint64_t time);
+	void add(int trackingId, const Observation &observation);
+	// tracks not added in the frame are kept until the slot is needed
+	void endFrame();
+	void clear();
+
+	// reader. false if the tracking ID is not stored
+	bool isActive(int trackingId) const;
+	// latest observation
+	bool getLatest(int trackingId, Observation &out) const;
+	// mean velocity of x, y (HVC coordinate / sec) over the last window millis
+	bool getVelocity(int trackingId, uint64_t window, ofVec2f &out) const;
+	// total path length since the track appeared (not limited to the capacity)
+	bool getPathLength(int trackingId, float &out) const;
+	bool getFirstTime(int trackingId, uint64_t &out) const;
+	// copy up to maxCount observations, oldest first. return count, -1 if not stored
+	int getHistory(int trackingId, Observation *out, int maxCount) const;
+	// tracking IDs of the stored tracks. return count
+	int getTrackingIds(int *out, int maxCount, bool activeOnly = true) const;
+
+private:
+	struct Track {
+		std::atomic<int> trackingId;
+		std::atomic<unsigned int> sequence;
+		std::atomic<bool> active;
+		bool seen;
+		int head;  // next write position
+		int count;
+		uint64_t firstTime;
+		float pathLength;
+	};
+
+	int findSlot(int trackingId) const;
+	void write(int slot, const Observation &o);
+	// f(base, capacity, track), base is the first index of the slot in the field buffers
+	template<typename F> bool read(int trackingId, F f) const;
+
+	std::atomic<int> capacity;
+	Track tracks[maxTracks];
+	vector<uint64_t> times;
+	vector<float> xs, ys, sizes;
+	vector<float> pitches, rolls, yaws;
+	vector<float> gazeLRs, gazeUDs;
+	uint64_t frameTime;
+};
+
+template<typename F>
+bool ofxHvcP2TrajectoryStore::read(int trackingId, F f) const {
+	if (trackingId < 0) return false;
+	for (int slot = 0; slot < maxTracks; ++slot) {
+		auto &t = tracks[slot];
+		if (t.trackingId.load(std::memory_order_relaxed) != trackingId) continue;
+
+		while (true) {
+			unsigned int before = t.sequence.load(std::memory_order_acquire);
+			if (before & 1) continue;
+			if (t.trackingId.load(std::memory_order_relaxed) != trackingId) return false;
+			// capacity only changes while the sequence is odd
+			f(slot * maxCapacity, capacity.load(std::memory_order_relaxed), t);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (t.sequence.load(std::memory_order_relaxed) == before) return true;
+		}
+	}
+	return false;
+}